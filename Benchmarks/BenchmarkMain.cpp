@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    Runs every SimpleEQ benchmark and prints its timings.
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../Source/FilterKernels.h"
+
+#include <iostream>
+
+void printBenchmarkResult(const juce::String& name, double nanosecondsPerCall, int samplesPerCall)
+{
+    auto line = name.paddedRight(' ', 48) + juce::String(nanosecondsPerCall, 1) + " ns";
+
+    if (samplesPerCall > 0)
+        line << ", " << juce::String(nanosecondsPerCall / samplesPerCall, 2) << " ns per sample";
+
+    std::cout << line << std::endl;
+}
+
+int main()
+{
+    //parameters and the value tree expect a message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+   #if JUCE_DEBUG
+    std::cout << "Warning: this is a Debug build, the timings are not representative" << std::endl;
+   #endif
+
+    std::cout << "Kernels selected for this CPU: "
+              << getKernelVariantName(selectFilterKernels().variant) << std::endl;
+
+    runProcessBenchmarks();
+    runStateBenchmarks();
+
+    return 0;
+}
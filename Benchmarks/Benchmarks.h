@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    Timing helpers shared by the SimpleEQ benchmarks.
+    Build in Release, numbers from a Debug build mean nothing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//runs a function callsPerRound times in a row, a few rounds over,
+//and returns the fastest round's time per call in nanoseconds
+//the fastest round is the one least disturbed by the rest of the machine
+template <typename Function>
+double measureNanosecondsPerCall(int callsPerRound, Function&& function)
+{
+    constexpr int numRounds = 7;
+    auto fastest = std::numeric_limits<double>::max();
+
+    for (int round = 0; round < numRounds; ++round)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < callsPerRound; ++i)
+            function();
+
+        const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        fastest = juce::jmin(fastest, seconds * 1.0e9 / callsPerRound);
+    }
+
+    return fastest;
+}
+
+//prints one line: the time per call, and per sample when a call processes audio
+void printBenchmarkResult(const juce::String& name, double nanosecondsPerCall, int samplesPerCall = 0);
+
+void runProcessBenchmarks();
+void runStateBenchmarks();
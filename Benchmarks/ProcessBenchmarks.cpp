@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    Throughput of the filter kernels, per instruction set, and of
+    processBlock end to end in the situations it handles differently.
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../Source/PluginProcessor.h"
+#include "../Source/FilterKernels.h"
+
+static constexpr double sampleRate = 48000.0;
+static constexpr int blockSize = 512;
+static constexpr int blocksPerRound = 2000;
+
+static void fillWithNoise(juce::AudioBuffer<float>& buffer, juce::Random& random)
+{
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample(channel, i, 0.25f * (2.f * random.nextFloat() - 1.f));
+}
+
+static SectionCoefficients toSection(const juce::dsp::IIR::Coefficients<float>& coefficients)
+{
+    const auto& c = coefficients.coefficients;
+    return { c[0], c[1], c[2], c[3], c[4] };
+}
+
+//the longest cascade processBlock runs, a Slope_48 low cut,
+//the peak and a Slope_48 high cut, for every supported variant
+static void benchmarkKernelVariants()
+{
+    using Coefficients = juce::dsp::IIR::Coefficients<float>;
+
+    std::array<SectionCoefficients, 9> sections;
+    const auto lowCut = juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(20.f, sampleRate, 8);
+    const auto highCut = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(20000.f, sampleRate, 8);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        sections[size_t(i)] = toSection(*lowCut[i]);
+        sections[size_t(i + 5)] = toSection(*highCut[i]);
+    }
+
+    sections[4] = toSection(*Coefficients::makePeakFilter(sampleRate, 1000.f, 1.f, 2.f));
+
+    juce::AudioBuffer<float> input(1, blockSize), buffer(1, blockSize);
+    juce::Random random(1);
+    fillWithNoise(input, random);
+
+    for (int v = 0; v < NumKernelVariants; ++v)
+    {
+        const auto variant = static_cast<KernelVariant>(v);
+        if (! isKernelVariantSupported(variant))
+            continue;
+
+        const auto kernels = getFilterKernels(variant);
+        std::array<SectionState, 9> states;
+
+        //fresh input every call, so the output neither decays nor grows
+        const auto nanoseconds = measureNanosecondsPerCall(blocksPerRound, [&]
+        {
+            buffer.copyFrom(0, 0, input, 0, 0, blockSize);
+            kernels.processCascade(buffer.getWritePointer(0), blockSize,
+                sections.data(), states.data(), int(sections.size()), 1.f, 1.f);
+        });
+
+        printBenchmarkResult(juce::String("processCascade, 9 sections, ") + getKernelVariantName(variant),
+            nanoseconds, blockSize);
+    }
+}
+
+static void prepare(SimpleEQAudioProcessor& processor)
+{
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+}
+
+//every band active, so the whole cascade runs
+static ChainSettings getBusySettings()
+{
+    ChainSettings settings;
+    settings.lowCutFreq = 40.f;
+    settings.lowCutSlope = Slope_48;
+    settings.peakFreq = 1000.f;
+    settings.peakGainInDecibels = 6.f;
+    settings.peakQuality = 1.f;
+    settings.highCutFreq = 16000.f;
+    settings.highCutSlope = Slope_48;
+    return settings;
+}
+
+//processBlock with steady knobs, with a knob moving on every block,
+//while morphing, and on silence once the filters have decayed
+static void benchmarkProcessBlock()
+{
+    juce::AudioBuffer<float> input(2, blockSize), buffer(2, blockSize);
+    juce::MidiBuffer midiMessages;
+    juce::Random random(2);
+    fillWithNoise(input, random);
+
+    auto measureProcessBlock = [&](SimpleEQAudioProcessor& processor, const juce::AudioBuffer<float>& source,
+                                   std::function<void(int)> beforeBlock)
+    {
+        int block = 0;
+
+        return measureNanosecondsPerCall(blocksPerRound, [&]
+        {
+            if (beforeBlock)
+                beforeBlock(block++);
+
+            buffer.makeCopyOf(source, true);
+            processor.processBlock(buffer, midiMessages);
+        });
+    };
+
+    {
+        SimpleEQAudioProcessor processor;
+        processor.setChainSettings(getBusySettings());
+        prepare(processor);
+
+        printBenchmarkResult("processBlock, steady settings", measureProcessBlock(processor, input, {}), blockSize);
+    }
+
+    {
+        SimpleEQAudioProcessor processor;
+        processor.setChainSettings(getBusySettings());
+        prepare(processor);
+
+        //one parameter change per block, so every block redesigns the peak
+        auto* peakFreq = processor.apvts.getParameter("Peak Freq");
+        printBenchmarkResult("processBlock, peak automated",
+            measureProcessBlock(processor, input, [peakFreq](int block)
+            {
+                peakFreq->setValueNotifyingHost(float(block % 100) / 100.f);
+            }), blockSize);
+    }
+
+    {
+        SimpleEQAudioProcessor processor;
+        auto other = getBusySettings();
+        other.lowCutFreq = 200.f;
+        other.peakFreq = 300.f;
+        other.peakGainInDecibels = -12.f;
+        other.highCutFreq = 5000.f;
+        processor.setChainSettings(other);
+        processor.storeSnapshot(1);
+        processor.setChainSettings(getBusySettings());
+        processor.storeSnapshot(0);
+        prepare(processor);
+
+        processor.apvts.getParameter("Morph Enabled")->setValueNotifyingHost(1.f);
+        auto* morph = processor.apvts.getParameter("Morph");
+
+        printBenchmarkResult("processBlock, morphing",
+            measureProcessBlock(processor, input, [morph](int block)
+            {
+                morph->setValueNotifyingHost(float(block % 100) / 100.f);
+            }), blockSize);
+    }
+
+    {
+        SimpleEQAudioProcessor processor;
+        processor.setChainSettings(getBusySettings());
+        prepare(processor);
+
+        juce::AudioBuffer<float> silence(2, blockSize);
+        silence.clear();
+
+        printBenchmarkResult("processBlock, silence", measureProcessBlock(processor, silence, {}), blockSize);
+    }
+}
+
+void runProcessBenchmarks()
+{
+    benchmarkKernelVariants();
+    benchmarkProcessBlock();
+}
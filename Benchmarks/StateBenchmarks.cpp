@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    Save and load timings of the binary state, next to the whole
+    ValueTree path getStateInformation and setStateInformation used before.
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "../Source/PluginProcessor.h"
+
+static constexpr int callsPerRound = 2000;
+
+static ChainSettings getNonDefaultSettings()
+{
+    ChainSettings settings;
+    settings.lowCutFreq = 80.f;
+    settings.lowCutSlope = Slope_24;
+    settings.peakFreq = 1000.f;
+    settings.peakGainInDecibels = 6.f;
+    settings.peakQuality = 2.f;
+    settings.highCutFreq = 12000.f;
+    settings.highCutSlope = Slope_36;
+    return settings;
+}
+
+static juce::String withSize(const juce::String& name, const juce::MemoryBlock& block)
+{
+    return name + " (" + juce::String(int(block.getSize())) + " bytes)";
+}
+
+void runStateBenchmarks()
+{
+    SimpleEQAudioProcessor processor;
+    processor.setChainSettings(getNonDefaultSettings());
+
+    //hosts hand getStateInformation an empty block every time
+    juce::MemoryBlock binaryState, treeState;
+
+    const auto binarySave = measureNanosecondsPerCall(callsPerRound, [&]
+    {
+        binaryState.reset();
+        processor.getStateInformation(binaryState);
+    });
+
+    const auto treeSave = measureNanosecondsPerCall(callsPerRound, [&]
+    {
+        treeState.reset();
+        juce::MemoryOutputStream stream(treeState, true);
+        processor.apvts.state.writeToStream(stream);
+    });
+
+    printBenchmarkResult(withSize("save, binary", binaryState), binarySave);
+    printBenchmarkResult(withSize("save, ValueTree", treeState), treeSave);
+
+    //loads alternate between two presets, so every load changes something
+    SimpleEQAudioProcessor other;
+    auto otherSettings = getNonDefaultSettings();
+    otherSettings.peakFreq = 300.f;
+    otherSettings.highCutSlope = Slope_12;
+    other.setChainSettings(otherSettings);
+
+    juce::MemoryBlock otherBinaryState, otherTreeState;
+    other.getStateInformation(otherBinaryState);
+    {
+        juce::MemoryOutputStream stream(otherTreeState, true);
+        other.apvts.copyState().writeToStream(stream);
+    }
+
+    //written from the flushed state, like a host would have saved it
+    treeState.reset();
+    {
+        juce::MemoryOutputStream stream(treeState, true);
+        processor.apvts.copyState().writeToStream(stream);
+    }
+
+    int load = 0;
+    const auto binaryLoad = measureNanosecondsPerCall(callsPerRound, [&]
+    {
+        const auto& state = (load++ % 2 == 0) ? otherBinaryState : binaryState;
+        processor.setStateInformation(state.getData(), int(state.getSize()));
+    });
+
+    load = 0;
+    const auto treeLoad = measureNanosecondsPerCall(callsPerRound, [&]
+    {
+        const auto& state = (load++ % 2 == 0) ? otherTreeState : treeState;
+        auto tree = juce::ValueTree::readFromData(state.getData(), state.getSize());
+        processor.apvts.replaceState(tree);
+    });
+
+    printBenchmarkResult("load, binary", binaryLoad);
+    printBenchmarkResult("load, ValueTree", treeLoad);
+}
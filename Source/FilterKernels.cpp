@@ -0,0 +1,283 @@
+/*
+  ==============================================================================
+
+    Filtering kernels, compiled once per instruction set and picked at
+    runtime, so one binary uses the best the host CPU has.
+
+  ==============================================================================
+*/
+
+#include "FilterKernels.h"
+
+//the x86 variants are the same code compiled with target attributes,
+//which only GCC and Clang support. Other compilers get the generic kernels,
+//and so does ARM, where NEON is baseline and the compiler can use it for them
+#if JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)
+ #define SIMPLEEQ_X86_VARIANTS 1
+#else
+ #define SIMPLEEQ_X86_VARIANTS 0
+#endif
+
+//==============================================================================
+//kernel bodies, inlined into every variant below
+
+template <bool applyGain>
+static forcedinline void processSectionBody(float* __restrict samples, int numSamples,
+    const SectionCoefficients& c, SectionState& state, float gain, float gainStep)
+{
+    auto s1 = state.s1;
+    auto s2 = state.s2;
+
+    //same recursion as juce::dsp::IIR::Filter uses for second order
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto input = samples[i];
+        const auto output = c.b0 * input + s1;
+        s1 = c.b1 * input - c.a1 * output + s2;
+        s2 = c.b2 * input - c.a2 * output;
+
+        if (applyGain)
+        {
+            samples[i] = output * gain;
+            gain += gainStep;
+        }
+        else
+        {
+            samples[i] = output;
+        }
+    }
+
+    JUCE_SNAP_TO_ZERO(s1);
+    JUCE_SNAP_TO_ZERO(s2);
+    state.s1 = s1;
+    state.s2 = s2;
+}
+
+static forcedinline void processCascadeBody(float* __restrict samples, int numSamples,
+    const SectionCoefficients* __restrict sections, SectionState* __restrict states, int numSections,
+    float startGain, float endGain)
+{
+    const auto hasGain = ! isSameValue(startGain, 1.f) || ! isSameValue(endGain, 1.f);
+    const auto gainStep = numSamples > 0 ? (endGain - startGain) / float(numSamples) : 0.f;
+
+    //the gain rides along with the last section
+    const auto numPlainSections = hasGain ? numSections - 1 : numSections;
+
+    for (int s = 0; s < numPlainSections; ++s)
+        processSectionBody<false>(samples, numSamples, sections[s], states[s], 1.f, 0.f);
+
+    if (! hasGain)
+        return;
+
+    if (numSections > 0)
+    {
+        processSectionBody<true>(samples, numSamples, sections[numSections - 1],
+            states[numSections - 1], startGain, gainStep);
+    }
+    else
+    {
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] *= startGain + gainStep * float(i);
+    }
+}
+
+static forcedinline void evaluateMagnitudesBody(const double* __restrict phis, double* __restrict magnitudes,
+    int numPoints, const SectionCoefficients* __restrict sections, int numSections)
+{
+    for (int s = 0; s < numSections; ++s)
+    {
+        //|B|^2 = (b0 + b1 + b2)^2 - 4 (b0 b1 + 4 b0 b2 + b1 b2) phi + 16 b0 b2 phi^2
+        //and the same for A with a0 == 1
+        const double b0 = sections[s].b0, b1 = sections[s].b1, b2 = sections[s].b2;
+        const double a1 = sections[s].a1, a2 = sections[s].a2;
+
+        const auto bSum = b0 + b1 + b2;
+        const auto bConstant = bSum * bSum;
+        const auto bLinear = 4.0 * (b0 * b1 + 4.0 * b0 * b2 + b1 * b2);
+        const auto bSquare = 16.0 * b0 * b2;
+
+        const auto aSum = 1.0 + a1 + a2;
+        const auto aConstant = aSum * aSum;
+        const auto aLinear = 4.0 * (a1 + 4.0 * a2 + a1 * a2);
+        const auto aSquare = 16.0 * a2;
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const auto phi = phis[i];
+            const auto numerator = bConstant - phi * (bLinear - phi * bSquare);
+            const auto denominator = aConstant - phi * (aLinear - phi * aSquare);
+
+            //rounding can push a zero of the response just below 0
+            magnitudes[i] *= std::sqrt(std::max(numerator, 0.0) / denominator);
+        }
+    }
+}
+
+static forcedinline void evaluateResponseBody(const double* __restrict cosOmegas, const double* __restrict sinOmegas,
+    double* __restrict reals, double* __restrict imags, double* __restrict groupDelays,
+    int numPoints, const SectionCoefficients* __restrict sections, int numSections)
+{
+    for (int s = 0; s < numSections; ++s)
+    {
+        const double b0 = sections[s].b0, b1 = sections[s].b1, b2 = sections[s].b2;
+        const double a1 = sections[s].a1, a2 = sections[s].a2;
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            //e^-jw and e^-j2w
+            const auto c1 = cosOmegas[i];
+            const auto s1 = sinOmegas[i];
+            const auto c2 = 2.0 * c1 * c1 - 1.0;
+            const auto s2 = 2.0 * s1 * c1;
+
+            //B and A, and their derivatives sum(k p_k e^-jkw) for the group delay
+            const auto bReal = b0 + b1 * c1 + b2 * c2;
+            const auto bImag = -(b1 * s1 + b2 * s2);
+            const auto dbReal = b1 * c1 + 2.0 * b2 * c2;
+            const auto dbImag = -(b1 * s1 + 2.0 * b2 * s2);
+
+            const auto aReal = 1.0 + a1 * c1 + a2 * c2;
+            const auto aImag = -(a1 * s1 + a2 * s2);
+            const auto daReal = a1 * c1 + 2.0 * a2 * c2;
+            const auto daImag = -(a1 * s1 + 2.0 * a2 * s2);
+
+            const auto bNorm = bReal * bReal + bImag * bImag;
+            const auto aNorm = aReal * aReal + aImag * aImag;
+
+            //group delay of a polynomial is Re(D / P), a zero exactly on the
+            //unit circle has no defined delay, so it adds nothing
+            const auto bDelay = bNorm > 0.0 ? (dbReal * bReal + dbImag * bImag) / bNorm : 0.0;
+            const auto aDelay = (daReal * aReal + daImag * aImag) / aNorm;
+            groupDelays[i] += bDelay - aDelay;
+
+            //H *= B / A, i.e. B * conj(A) / |A|^2
+            const auto hReal = (bReal * aReal + bImag * aImag) / aNorm;
+            const auto hImag = (bImag * aReal - bReal * aImag) / aNorm;
+            const auto real = reals[i];
+            const auto imag = imags[i];
+            reals[i] = real * hReal - imag * hImag;
+            imags[i] = real * hImag + imag * hReal;
+        }
+    }
+}
+
+//==============================================================================
+//one wrapper per variant, each compiled for its own instruction set
+
+#define SIMPLEEQ_DEFINE_KERNELS(suffix, attributes) \
+    attributes static void processCascade##suffix(float* samples, int numSamples, \
+        const SectionCoefficients* sections, SectionState* states, int numSections, \
+        float startGain, float endGain) \
+    { \
+        processCascadeBody(samples, numSamples, sections, states, numSections, startGain, endGain); \
+    } \
+    attributes static void evaluateMagnitudes##suffix(const double* phis, double* magnitudes, \
+        int numPoints, const SectionCoefficients* sections, int numSections) \
+    { \
+        evaluateMagnitudesBody(phis, magnitudes, numPoints, sections, numSections); \
+    } \
+    attributes static void evaluateResponse##suffix(const double* cosOmegas, const double* sinOmegas, \
+        double* reals, double* imags, double* groupDelays, \
+        int numPoints, const SectionCoefficients* sections, int numSections) \
+    { \
+        evaluateResponseBody(cosOmegas, sinOmegas, reals, imags, groupDelays, numPoints, sections, numSections); \
+    }
+
+SIMPLEEQ_DEFINE_KERNELS(Generic, )
+
+#if SIMPLEEQ_X86_VARIANTS
+SIMPLEEQ_DEFINE_KERNELS(SSE2, __attribute__((target("sse2"))))
+SIMPLEEQ_DEFINE_KERNELS(AVX2, __attribute__((target("avx2,fma"))))
+SIMPLEEQ_DEFINE_KERNELS(AVX512, __attribute__((target("avx512f,avx2,fma"))))
+#endif
+
+#undef SIMPLEEQ_DEFINE_KERNELS
+
+//==============================================================================
+bool isKernelVariantSupported(KernelVariant variant)
+{
+    switch (variant)
+    {
+    case Kernel_Generic:
+        return true;
+    case Kernel_SSE2:
+        return SIMPLEEQ_X86_VARIANTS && juce::SystemStats::hasSSE2();
+    case Kernel_AVX2:
+        return SIMPLEEQ_X86_VARIANTS && juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+    case Kernel_AVX512:
+        return SIMPLEEQ_X86_VARIANTS && juce::SystemStats::hasAVX512F() && juce::SystemStats::hasFMA3();
+    case NumKernelVariants:
+        break;
+    }
+
+    return false;
+}
+
+FilterKernels getFilterKernels(KernelVariant variant)
+{
+    jassert(isKernelVariantSupported(variant));
+
+    //only the variants this build contains can be named here
+   #if SIMPLEEQ_X86_VARIANTS
+    if (variant == Kernel_SSE2)
+        return { Kernel_SSE2, processCascadeSSE2, evaluateMagnitudesSSE2, evaluateResponseSSE2 };
+
+    if (variant == Kernel_AVX2)
+        return { Kernel_AVX2, processCascadeAVX2, evaluateMagnitudesAVX2, evaluateResponseAVX2 };
+
+    if (variant == Kernel_AVX512)
+        return { Kernel_AVX512, processCascadeAVX512, evaluateMagnitudesAVX512, evaluateResponseAVX512 };
+   #endif
+
+    return { Kernel_Generic, processCascadeGeneric, evaluateMagnitudesGeneric, evaluateResponseGeneric };
+}
+
+const char* getKernelVariantName(KernelVariant variant)
+{
+    switch (variant)
+    {
+    case Kernel_Generic:    return "generic";
+    case Kernel_SSE2:       return "sse2";
+    case Kernel_AVX2:       return "avx2";
+    case Kernel_AVX512:     return "avx512";
+    case NumKernelVariants: break;
+    }
+
+    return "";
+}
+
+double getPhiForFrequency(double frequency, double sampleRate)
+{
+    const auto s = std::sin(juce::MathConstants<double>::pi * frequency / sampleRate);
+    return s * s;
+}
+
+static KernelVariant chooseKernelVariant()
+{
+    const auto forced = juce::SystemStats::getEnvironmentVariable("SIMPLEEQ_KERNEL", {});
+
+    if (forced.isNotEmpty())
+    {
+        for (int v = 0; v < NumKernelVariants; ++v)
+        {
+            const auto variant = static_cast<KernelVariant>(v);
+            if (forced.equalsIgnoreCase(getKernelVariantName(variant)) && isKernelVariantSupported(variant))
+                return variant;
+        }
+
+        //unknown name, or this CPU can't run it
+        jassertfalse;
+    }
+
+    for (auto variant : { Kernel_AVX512, Kernel_AVX2, Kernel_SSE2 })
+        if (isKernelVariantSupported(variant))
+            return variant;
+
+    return Kernel_Generic;
+}
+
+FilterKernels selectFilterKernels()
+{
+    static const auto kernels = getFilterKernels(chooseKernelVariant());
+    return kernels;
+}
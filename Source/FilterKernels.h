@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    Filtering kernels, compiled once per instruction set and picked at
+    runtime, so one binary uses the best the host CPU has.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//Raw coefficients of one second order section, normalised so a0 == 1
+//Plain value type, so filters can be designed on the audio thread
+//without allocating a new Coefficients object every time
+struct SectionCoefficients
+{
+    float b0{ 1.f };
+    float b1{ 0.f };
+    float b2{ 0.f };
+    float a1{ 0.f };
+    float a2{ 0.f };
+};
+
+//a == b without tripping -Wfloat-equal, for the places that really mean
+//exactly equal, like spotting a changed setting or a gain of exactly 1
+template <typename FloatType>
+constexpr bool isSameValue(FloatType a, FloatType b)
+{
+    return ! (a < b || b < a);
+}
+
+//the two delay registers of a transposed direct form II section
+struct SectionState
+{
+    float s1{ 0.f };
+    float s2{ 0.f };
+};
+
+//instruction sets we compile kernels for
+//the evaluators work on many independent points, so they vectorise and gain the
+//most. The cascade is a serial recursion, where a variant only adds FMA
+enum KernelVariant
+{
+    Kernel_Generic,
+    Kernel_SSE2,
+    Kernel_AVX2,
+    Kernel_AVX512,
+    NumKernelVariants
+};
+
+//runs samples through the sections in series, in place
+//the output is multiplied by a gain ramping linearly from startGain to endGain,
+//applied in the last section's loop so it costs no extra pass over the buffer
+using ProcessCascadeFunction = void (*)(float* samples, int numSamples,
+    const SectionCoefficients* sections, SectionState* states, int numSections,
+    float startGain, float endGain);
+
+//multiplies each magnitude by the response of the sections
+//frequencies are passed as phi = sin^2(omega / 2), which keeps the
+//closed form accurate for cut filters far below the sample rate
+using EvaluateMagnitudesFunction = void (*)(const double* phis, double* magnitudes,
+    int numPoints, const SectionCoefficients* sections, int numSections);
+
+//full complex response and group delay of the sections in one pass
+//frequencies are passed as cos(omega) and sin(omega)
+//each point's (real, imag) is multiplied by the response and
+//its group delay, in samples, has the sections' group delay added
+using EvaluateResponseFunction = void (*)(const double* cosOmegas, const double* sinOmegas,
+    double* reals, double* imags, double* groupDelays,
+    int numPoints, const SectionCoefficients* sections, int numSections);
+
+//one compiled variant of every kernel
+struct FilterKernels
+{
+    KernelVariant variant{ Kernel_Generic };
+    ProcessCascadeFunction processCascade{ nullptr };
+    EvaluateMagnitudesFunction evaluateMagnitudes{ nullptr };
+    EvaluateResponseFunction evaluateResponse{ nullptr };
+};
+
+//whether this build contains the variant and this CPU can run it
+bool isKernelVariantSupported(KernelVariant variant);
+
+//kernels for a given variant, which must be supported
+FilterKernels getFilterKernels(KernelVariant variant);
+
+//best supported variant, chosen once and cached
+//set the SIMPLEEQ_KERNEL environment variable (generic, sse2, avx2
+//or avx512) to force a variant when debugging
+FilterKernels selectFilterKernels();
+
+const char* getKernelVariantName(KernelVariant variant);
+
+//phi for a frequency in Hz, see EvaluateMagnitudesFunction
+double getPhiForFrequency(double frequency, double sampleRate);
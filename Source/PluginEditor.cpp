@@ -18,12 +18,24 @@ ResponseCurveComponent::ResponseCurveComponent(SimpleEQAudioProcessor& p) : audi
         param->addListener(this);
     }
 
-    //starting the timer
-    startTimerHz(60);
+    //shows the current settings straight away
+    chainSettings = audioProcessor.getTargetChainSettings();
+
+    addAndMakeVisible(phaseButton);
+    addAndMakeVisible(groupDelayButton);
+    phaseButton.onClick = [this] { refreshCurves(); };
+    groupDelayButton.onClick = [this] { refreshCurves(); };
+
+    //paint covers every pixel, so nothing behind needs repainting
+    setOpaque(true);
+
+    //no timer until something changes
 }
 
 ResponseCurveComponent::~ResponseCurveComponent()
 {
+    cancelPendingUpdate();
+
     const auto& params = audioProcessor.getParameters();
     for (auto param : params)
     {
@@ -33,113 +45,494 @@ ResponseCurveComponent::~ResponseCurveComponent()
 
 void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue)
 {
+    juce::ignoreUnused(parameterIndex, newValue);
     parametersChanged.set(true);
+
+    //automation calls this from the audio thread too, which is fine,
+    //SliderAttachment does the same and repeated calls merge into one update
+    triggerAsyncUpdate();
 }
 void ResponseCurveComponent::parameterGestureChanged(int parameterIndex, bool gestureIsStarting)
 {
-    parametersChanged.set(true);
+    //gestures don't change the curve
+    juce::ignoreUnused(parameterIndex, gestureIsStarting);
+}
+
+void ResponseCurveComponent::snapshotStored()
+{
+    //only shows while morphing is on, the curve follows the knobs otherwise
+    if (audioProcessor.apvts.getRawParameterValue("Morph Enabled")->load() > 0.5f)
+    {
+        parametersChanged.set(true);
+        triggerAsyncUpdate();
+    }
+}
+
+void ResponseCurveComponent::handleAsyncUpdate()
+{
+    //any number of changes before this runs end up as one wake up
+    setUpdateRate(activeRateHz);
 }
 
 void ResponseCurveComponent::timerCallback()
 {
+    //hidden or minimised, stop until we're back and keep the flag till then
+    if (! isShowing())
+    {
+        stopTimer();
+        return;
+    }
+
     //if Parameters have been changed, set paramters change to false
     if (parametersChanged.compareAndSetBool(false, true))
     {
-        //update monochain
-        auto chainSettings = getChainSettings(audioProcessor.apvts);
-        auto peakCoefficients = makePeakFilter(chainSettings, audioProcessor.getSampleRate());
-        updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+        auto start = juce::Time::getMillisecondCounterHiRes();
+        chainSettings = audioProcessor.getTargetChainSettings();
+
+        //signal repaint of just the part of the curve that moved
+        refreshCurves();
+        addUpdateTime(juce::Time::getMillisecondCounterHiRes() - start);
+
+        idleTicks = 0;
+        setUpdateRate(activeRateHz);
+    }
+    //nothing changed for half a second, the next change starts it again
+    else if (++idleTicks > activeRateHz / 2)
+    {
+        stopTimer();
+    }
+}
+
+void ResponseCurveComponent::setUpdateRate(int rateHz)
+{
+    if (! isShowing())
+        stopTimer();
+    else if (! isTimerRunning() || getTimerInterval() != 1000 / rateHz)
+        startTimerHz(rateHz);
+}
+
+void ResponseCurveComponent::restartTimerIfShowing()
+{
+    //changes that came in while hidden get picked up straight away
+    if (! isTimerRunning())
+    {
+        if (parametersChanged.get())
+            setUpdateRate(activeRateHz);
+    }
+    else if (! isShowing())
+    {
+        stopTimer();
+    }
+}
+
+void ResponseCurveComponent::visibilityChanged()
+{
+    restartTimerIfShowing();
+}
+
+void ResponseCurveComponent::parentHierarchyChanged()
+{
+    restartTimerIfShowing();
+}
+
+void ResponseCurveComponent::addUpdateTime(double milliseconds)
+{
+    //slowly follows the cost of an update, and aims to spend at most a
+    //quarter of the time between updates on them
+    averageUpdateMs += 0.1 * (milliseconds - averageUpdateMs);
+
+    auto affordableRate = averageUpdateMs > 0.0 ? int(250.0 / averageUpdateMs) : maxActiveRateHz;
+    activeRateHz = juce::jlimit(minActiveRateHz, maxActiveRateHz, affordableRate);
+}
+
+//Path through one point per pixel column, starting at x
+//points that move the curve by less than half a pixel are skipped, so flat
+//stretches become one line. Jumps bigger than breakDistance start a new sub path
+static juce::Path makeDecimatedPath(const std::vector<float>& ys, float x, float breakDistance)
+{
+    juce::Path path;
+
+    if (ys.empty())
+        return path;
+
+    path.startNewSubPath(x, ys.front());
+    size_t lastIndex = 0;
+
+    for (size_t i = 1; i < ys.size(); ++i)
+    {
+        const auto pointX = x + float(i);
+
+        const auto y = ys[i];
+        const auto isLast = i + 1 == ys.size();
+
+        if (std::abs(y - ys[i - 1]) > breakDistance)
+        {
+            if (lastIndex != i - 1)
+                path.lineTo(pointX - 1.f, ys[i - 1]);
 
-        auto lowCutCoefficients = makeLowCutFilter(chainSettings,
-            audioProcessor.getSampleRate());
-        auto highCutCoefficients = makeHighCutFilter(chainSettings,
-            audioProcessor.getSampleRate());
-        updateCutFilter(monoChain.get<ChainPositions::LowCut>(),
-            lowCutCoefficients, chainSettings.lowCutSlope);
-        updateCutFilter(monoChain.get<ChainPositions::HighCut>(),
-            highCutCoefficients, chainSettings.highCutSlope);
+            path.startNewSubPath(pointX, y);
+            lastIndex = i;
+            continue;
+        }
 
-        //signal repaint
-        repaint();
+        const auto distance = std::abs(y - ys[lastIndex]);
+
+        if (distance < 0.5f && ! isLast)
+            continue;
+
+        //keeps the corner where a flat stretch turns steep
+        if (lastIndex != i - 1 && distance > 1.f)
+            path.lineTo(pointX - 1.f, ys[i - 1]);
+
+        path.lineTo(pointX, y);
+        lastIndex = i;
     }
+
+    return path;
 }
 
 void ResponseCurveComponent::paint(juce::Graphics& g)
 {
     using namespace juce;
+
+    auto start = Time::getMillisecondCounterHiRes();
+
+    //a window coming back from being minimised doesn't tell its children,
+    //but it does repaint them
+    if (! isTimerRunning())
+        restartTimerIfShowing();
+
+    //static layers come from the cached image, one image pixel per physical pixel
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (background.isNull() || ! isSameValue(scale, backgroundScale))
+        renderBackground(scale);
+
+    g.drawImage(background, getLocalBounds().toFloat());
+
+    if (phaseButton.getToggleState())
+    {
+        g.setColour(Colours::lightblue);
+        g.strokePath(phaseCurve, PathStrokeType(1.f));
+    }
+
+    if (groupDelayButton.getToggleState())
+    {
+        g.setColour(Colours::lightgreen);
+        g.strokePath(groupDelayCurve, PathStrokeType(1.f));
+        drawGroupDelayLabels(g);
+    }
+
+    g.setColour(Colours::white);
+    g.strokePath(responseCurve, PathStrokeType(2.f));
+
+    addUpdateTime(Time::getMillisecondCounterHiRes() - start);
+}
+
+void ResponseCurveComponent::resized()
+{
+    //overlay toggles in the top right corner
+    auto buttonArea = getLocalBounds().reduced(4).removeFromTop(20);
+    groupDelayButton.setBounds(buttonArea.removeFromRight(100));
+    phaseButton.setBounds(buttonArea.removeFromRight(70));
+
+    //the static layers are redrawn at the new size on the next paint
+    background = juce::Image();
+    updateCurves();
+}
+
+void ResponseCurveComponent::renderBackground(float scale)
+{
+    using namespace juce;
+
+    auto responseArea = getLocalBounds();
+    background = Image(Image::RGB, jmax(1, roundToInt(float(responseArea.getWidth()) * scale)),
+        jmax(1, roundToInt(float(responseArea.getHeight()) * scale)), true);
+    backgroundScale = scale;
+
+    //drawn in component coordinates, scaled up to the image's pixels
+    Graphics g(background);
+    g.addTransform(AffineTransform::scale(scale));
+
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll(Colours::black);
 
+    const auto w = float(responseArea.getWidth());
+    const auto top = float(responseArea.getY());
+    const auto bottom = float(responseArea.getBottom());
+
+    g.setFont(10.f);
+
+    //frequency grid and labels
+    const float freqs[] = { 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000 };
+    for (auto freq : freqs)
+    {
+        auto x = w * mapFromLog10(freq, 20.f, 20000.f);
+
+        g.setColour(Colours::dimgrey);
+        g.drawVerticalLine(roundToInt(x), top, bottom);
+
+        String label;
+        if (freq >= 1000.f)
+            label << roundToInt(freq / 1000.f) << "k";
+        else
+            label << roundToInt(freq);
+
+        g.setColour(Colours::lightgrey);
+        g.drawText(label, Rectangle<float>(jmin(x + 2.f, w - 32.f), bottom - 14.f, 30.f, 12.f),
+            Justification::centredLeft);
+    }
+
+    //gain grid and labels, the same -24 to +24 dB range as the curve
+    const int gains[] = { -24, -12, 0, 12, 24 };
+    for (auto gain : gains)
+    {
+        auto y = jmap(float(gain), -24.f, 24.f, bottom, top);
+
+        g.setColour(gain == 0 ? Colours::grey : Colours::dimgrey);
+        g.drawHorizontalLine(roundToInt(y), 0.f, w);
+
+        String label;
+        if (gain > 0)
+            label << "+";
+        label << gain << "dB";
+
+        g.setColour(Colours::lightgrey);
+        g.drawText(label, Rectangle<float>(w - 40.f, jlimit(top, bottom - 12.f, y - 12.f), 36.f, 12.f),
+            Justification::centredRight);
+    }
+
+    g.setColour(Colours::orange);
+    g.drawRoundedRectangle(responseArea.toFloat(), 4.f, 1.f);
+}
+
+void ResponseCurveComponent::updateCurves()
+{
+    using namespace juce;
+
     auto responseArea = getLocalBounds();
     auto w = responseArea.getWidth();
-     
-    auto& lowcut = monoChain.get<ChainPositions::LowCut>();
-    auto& peak = monoChain.get<ChainPositions::Peak>();
-    auto& highcut = monoChain.get<ChainPositions::HighCut>();
 
+    if (w <= 0)
+        return;
+
+    updateResponse();
+    const auto numPoints = size_t(w);
+
+    //Drawing the response Curve oof
+    const float outputMin = float(responseArea.getBottom());
+    const float outputMax = float(responseArea.getY());
+    const float x = float(responseArea.getX());
+    curveYs.resize(numPoints);
+
+    for (size_t i = 0; i < numPoints; ++i)
+        curveYs[i] = jmap(float(mags[i]), -24.f, 24.f, outputMin, outputMax);
+
+    responseCurve = makeDecimatedPath(curveYs, x, std::numeric_limits<float>::max());
+    auto bounds = responseCurve.getBounds();
+
+    //phase, -pi at the bottom to pi at the top, broken where it wraps
+    phaseCurve.clear();
+    if (phaseButton.getToggleState())
+    {
+        for (size_t i = 0; i < numPoints; ++i)
+            curveYs[i] = jmap(float(phases[i]), -MathConstants<float>::pi, MathConstants<float>::pi,
+                outputMin, outputMax);
+
+        phaseCurve = makeDecimatedPath(curveYs, x, 0.5f * (outputMin - outputMax));
+        bounds = bounds.getUnion(phaseCurve.getBounds());
+    }
+
+    //group delay, scaled to the range it covers, negative delays included
+    groupDelayCurve.clear();
+    if (groupDelayButton.getToggleState())
+    {
+        updateGroupDelayRange();
+
+        for (size_t i = 0; i < numPoints; ++i)
+            curveYs[i] = jmap(jlimit(groupDelayMin, groupDelayMax, float(groupDelays[i])),
+                groupDelayMin, groupDelayMax, outputMin, outputMax);
+
+        groupDelayCurve = makeDecimatedPath(curveYs, x, std::numeric_limits<float>::max());
+
+        //the labels change with the range, so they repaint with the curve
+        bounds = bounds.getUnion(groupDelayCurve.getBounds())
+            .getUnion(getGroupDelayLabelArea().toFloat());
+    }
+
+    //room for the stroke width
+    curveBounds = bounds.getSmallestIntegerContainer().expanded(2);
+}
+
+void ResponseCurveComponent::updateGroupDelayRange()
+{
+    auto lowest = 0.f, highest = 0.f;
+
+    for (auto delay : groupDelays)
+    {
+        if (std::isfinite(delay))
+        {
+            lowest = juce::jmin(lowest, float(delay));
+            highest = juce::jmax(highest, float(delay));
+        }
+    }
+
+    //at least 1 ms, so a flat delay doesn't blow rounding errors up
+    highest = juce::jmax(highest, lowest + 1.f);
+
+    //about four steps over the range
+    const auto roughStep = (highest - lowest) / 4.f;
+    const auto power = std::pow(10.f, std::floor(std::log10(roughStep)));
+
+    groupDelayStep = 10.f * power;
+    for (auto multiple : { 1.f, 2.f, 5.f })
+    {
+        if (multiple * power >= roughStep)
+        {
+            groupDelayStep = multiple * power;
+            break;
+        }
+    }
+
+    groupDelayMin = groupDelayStep * std::floor(lowest / groupDelayStep);
+    groupDelayMax = groupDelayStep * std::ceil(highest / groupDelayStep);
+}
+
+juce::Rectangle<int> ResponseCurveComponent::getGroupDelayLabelArea() const
+{
+    //down the left edge, above the frequency labels
+    return getLocalBounds().withTrimmedBottom(14).removeFromLeft(48);
+}
+
+void ResponseCurveComponent::drawGroupDelayLabels(juce::Graphics& g)
+{
+    using namespace juce;
+
+    const auto area = getGroupDelayLabelArea().toFloat();
+    const auto top = float(getLocalBounds().getY());
+    const auto bottom = float(getLocalBounds().getBottom());
+
+    g.setFont(10.f);
+
+    //counted in whole steps, so 0 ms comes out as exactly 0
+    const auto firstStep = roundToInt(groupDelayMin / groupDelayStep);
+    const auto lastStep = roundToInt(groupDelayMax / groupDelayStep);
+    const auto decimals = groupDelayStep < 1.f ? 1 : 0;
+
+    for (int step = firstStep; step <= lastStep; ++step)
+    {
+        const auto delay = float(step) * groupDelayStep;
+        const auto y = jmap(delay, groupDelayMin, groupDelayMax, bottom, top);
+
+        g.drawText(String(delay, decimals) + "ms",
+            Rectangle<float>(area.getX() + 4.f, jlimit(area.getY(), area.getBottom() - 12.f, y - 6.f), 40.f, 12.f),
+            Justification::centredLeft);
+    }
+}
+
+void ResponseCurveComponent::refreshCurves()
+{
+    //repaints where the old curves were and where the new ones are
+    auto oldBounds = curveBounds;
+    updateCurves();
+    repaint(oldBounds.getUnion(curveBounds));
+}
+
+void ResponseCurveComponent::updateResponse()
+{
+    using namespace juce;
+
+    auto w = getWidth();
+    const auto numPoints = size_t(juce::jmax(0, w));
     auto sampleRate = audioProcessor.getSampleRate();
 
-    std::vector<double> mags;
-    mags.resize(w);
-    for (int i = 0; i < w; ++i)
-    {
-        double mag = 1.f;
-        auto freq = mapToLog10(double(i) / double(w), 20.0, 20000.0);
-
-        if (!monoChain.isBypassed<ChainPositions::Peak>())
-            mag *= peak.coefficients->getMagnitudeForFrequency(freq,
-                sampleRate);
-
-        if (!lowcut.isBypassed<0>())
-            mag *= lowcut.get<0>().coefficients->getMagnitudeForFrequency(freq,
-                sampleRate);
-        if (!lowcut.isBypassed<1>())
-            mag *= lowcut.get<1>().coefficients->getMagnitudeForFrequency(freq,
-                sampleRate);
-        if (!lowcut.isBypassed<2>())
-            mag *= lowcut.get<2>().coefficients->getMagnitudeForFrequency(freq,
-                sampleRate);
-        if (!lowcut.isBypassed<3>())
-            mag *= lowcut.get<3>().coefficients->getMagnitudeForFrequency(freq,
-                sampleRate);
-
-        if (!highcut.isBypassed<0>())
-            mag *= highcut.get<0>().coefficients->getMagnitudeForFrequency(freq,
-                sampleRate);
-        if (!highcut.isBypassed<1>())
-            mag *= highcut.get<1>().coefficients->getMagnitudeForFrequency(freq,
-                sampleRate);
-        if (!highcut.isBypassed<2>())
-            mag *= highcut.get<2>().coefficients->getMagnitudeForFrequency(freq,
-                sampleRate);
-        if (!highcut.isBypassed<3>())
-            mag *= highcut.get<3>().coefficients->getMagnitudeForFrequency(freq,
-                sampleRate);
-
-        mags[i] = Decibels::gainToDecibels(mag);
+    //not prepared yet, draw as if running at 44.1 kHz
+    if (sampleRate <= 0.0)
+        sampleRate = 44100.0;
+
+    //frequencies only change with the width or the sample rate,
+    //and when they do every band is stale
+    if (cosOmegas.size() != numPoints || ! isSameValue(gridSampleRate, sampleRate))
+    {
+        for (auto* values : { &cosOmegas, &sinOmegas, &mags, &phases, &groupDelays })
+            values->resize(numPoints);
+
+        for (auto& band : bandResponses)
+        {
+            band.reals.resize(numPoints);
+            band.imags.resize(numPoints);
+            band.groupDelays.resize(numPoints);
+        }
+
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            auto freq = mapToLog10(double(i) / double(w), 20.0, 20000.0);
+            auto omega = MathConstants<double>::twoPi * freq / sampleRate;
+            cosOmegas[i] = std::cos(omega);
+            sinOmegas[i] = std::sin(omega);
+        }
+
+        gridSampleRate = sampleRate;
+        bandsEvaluated = false;
     }
 
+    const auto lowCutChanged = ! bandsEvaluated || lowCutDiffers(chainSettings, evaluatedSettings);
+    const auto peakChanged = ! bandsEvaluated || peakDiffers(chainSettings, evaluatedSettings);
+    const auto highCutChanged = ! bandsEvaluated || highCutDiffers(chainSettings, evaluatedSettings);
 
-    //Drawing the response Curve oof
-    Path responseCurve;
-    const double outputMin = responseArea.getBottom();
-    const double outputMax = responseArea.getY();
-    auto map = [outputMin, outputMax](double input)
+    if (! (lowCutChanged || peakChanged || highCutChanged))
+        return;
+
+    if (lowCutChanged)
     {
-        return jmap(input, -24.0, 24.0, outputMin, outputMax);
-    };
+        auto sections = makeLowCutSections(chainSettings, sampleRate);
+        evaluateBand(bandResponses[0], sections.data(), chainSettings.lowCutSlope + 1);
+    }
 
-    responseCurve.startNewSubPath(responseArea.getX(), map(mags.front()));
+    if (peakChanged)
+    {
+        auto section = makePeakSection(chainSettings, sampleRate);
+        evaluateBand(bandResponses[1], &section, 1);
+    }
 
-    for (size_t i = 1; i < mags.size(); ++i)
+    if (highCutChanged)
     {
-        responseCurve.lineTo(responseArea.getX() + i, map(mags[i]));
+        auto sections = makeHighCutSections(chainSettings, sampleRate);
+        evaluateBand(bandResponses[2], sections.data(), chainSettings.highCutSlope + 1);
     }
 
-    g.setColour(Colours::orange);
-    g.drawRoundedRectangle(responseArea.toFloat(), 4.f, 1.f);
-    g.setColour(Colours::white);
-    g.strokePath(responseCurve, PathStrokeType(2.f));
+    evaluatedSettings = chainSettings;
+    bandsEvaluated = true;
+
+    //combines the bands, responses multiply and group delays add
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        double real = 1.0, imag = 0.0, delay = 0.0;
+
+        for (auto& band : bandResponses)
+        {
+            auto newReal = real * band.reals[i] - imag * band.imags[i];
+            imag = real * band.imags[i] + imag * band.reals[i];
+            real = newReal;
+            delay += band.groupDelays[i];
+        }
+
+        mags[i] = Decibels::gainToDecibels(std::sqrt(real * real + imag * imag));
+        phases[i] = std::atan2(imag, real);
+        groupDelays[i] = delay * 1000.0 / sampleRate;
+    }
+}
+
+void ResponseCurveComponent::evaluateBand(BandResponse& band, const SectionCoefficients* sections, int numSections)
+{
+    std::fill(band.reals.begin(), band.reals.end(), 1.0);
+    std::fill(band.imags.begin(), band.imags.end(), 0.0);
+    std::fill(band.groupDelays.begin(), band.groupDelays.end(), 0.0);
+
+    //magnitude, phase and group delay of every pixel in one pass
+    kernels.evaluateResponse(cosOmegas.data(), sinOmegas.data(),
+        band.reals.data(), band.imags.data(), band.groupDelays.data(),
+        static_cast<int>(cosOmegas.size()), sections, numSections);
 }
 
 
@@ -155,7 +548,10 @@ SimpleEQAudioProcessorEditor::SimpleEQAudioProcessorEditor (SimpleEQAudioProcess
     lowCutFreqSliderAttachment(audioProcessor.apvts, "LowCut Freq", lowCutFreqSlider),
     highCutFreqSliderAttachment(audioProcessor.apvts, "HighCut Freq", highCutFreqSlider),
     lowCutSlopeSliderAttachment(audioProcessor.apvts, "LowCut Slope", lowCutSlopeSlider),
-    highCutSlopeSliderAttachment(audioProcessor.apvts, "HighCut Slope", highCutSlopeSlider)
+    highCutSlopeSliderAttachment(audioProcessor.apvts, "HighCut Slope", highCutSlopeSlider),
+    morphSliderAttachment(audioProcessor.apvts, "Morph", morphSlider),
+    morphEnabledButtonAttachment(audioProcessor.apvts, "Morph Enabled", morphEnabledButton),
+    autoGainButtonAttachment(audioProcessor.apvts, "Auto Gain", autoGainButton)
 {
 
 
@@ -165,6 +561,25 @@ SimpleEQAudioProcessorEditor::SimpleEQAudioProcessorEditor (SimpleEQAudioProcess
     {
         addAndMakeVisible(comp);
     }
+
+    //the knobs are stored into snapshots A and B
+    storeAButton.onClick = [this]
+    {
+        audioProcessor.storeSnapshot(0);
+        responseCurveComponent.snapshotStored();
+    };
+    storeBButton.onClick = [this]
+    {
+        audioProcessor.storeSnapshot(1);
+        responseCurveComponent.snapshotStored();
+    };
+
+    //A/B jumps the morph to the other end, the processor ramps it
+    switchABButton.onClick = [this]
+    {
+        auto* morph = audioProcessor.apvts.getParameter("Morph");
+        morph->setValueNotifyingHost(morph->getValue() < 0.5f ? 1.f : 0.f);
+    };
  
     
 
@@ -186,23 +601,30 @@ void SimpleEQAudioProcessorEditor::resized()
 
     //bounding box, reserving height, removing stores into response area and updates bounds
     auto bounds = getLocalBounds();
-    auto responseArea = bounds.removeFromTop(bounds.getHeight() * 0.33);
+    auto responseArea = bounds.removeFromTop(int(bounds.getHeight() * 0.33));
     responseCurveComponent.setBounds(responseArea);
 
+    //snapshot and auto gain controls along the bottom
+    auto snapshotArea = bounds.removeFromBottom(int(bounds.getHeight() * 0.15));
+    auto buttonWidth = snapshotArea.getWidth() / 8;
+    storeAButton.setBounds(snapshotArea.removeFromLeft(buttonWidth).reduced(2));
+    storeBButton.setBounds(snapshotArea.removeFromLeft(buttonWidth).reduced(2));
+    switchABButton.setBounds(snapshotArea.removeFromLeft(buttonWidth).reduced(2));
+    morphEnabledButton.setBounds(snapshotArea.removeFromLeft(buttonWidth).reduced(2));
+    autoGainButton.setBounds(snapshotArea.removeFromRight(buttonWidth * 3 / 2).reduced(2));
+    morphSlider.setBounds(snapshotArea);
 
-    responseCurveComponent.setBounds(responseArea);
-
-    auto lowCutArea = bounds.removeFromLeft(bounds.getWidth() * 0.33);
-    auto highCutArea = bounds.removeFromRight(bounds.getWidth() * 0.5);
+    auto lowCutArea = bounds.removeFromLeft(int(bounds.getWidth() * 0.33));
+    auto highCutArea = bounds.removeFromRight(int(bounds.getWidth() * 0.5));
 
-    lowCutFreqSlider.setBounds(lowCutArea.removeFromTop(lowCutArea.getHeight()*0.5));
+    lowCutFreqSlider.setBounds(lowCutArea.removeFromTop(int(lowCutArea.getHeight() * 0.5)));
     lowCutSlopeSlider.setBounds(lowCutArea); 
 
-    highCutFreqSlider.setBounds(highCutArea.removeFromTop(highCutArea.getHeight() * 0.5));
+    highCutFreqSlider.setBounds(highCutArea.removeFromTop(int(highCutArea.getHeight() * 0.5)));
     highCutSlopeSlider.setBounds(highCutArea);
 
-    peakFreqSlider.setBounds(bounds.removeFromTop(bounds.getHeight() * 0.33));
-    peakGainSlider.setBounds(bounds.removeFromTop(bounds.getHeight() * 0.5));
+    peakFreqSlider.setBounds(bounds.removeFromTop(int(bounds.getHeight() * 0.33)));
+    peakGainSlider.setBounds(bounds.removeFromTop(int(bounds.getHeight() * 0.5)));
     peakQualitySlider.setBounds(bounds);
 
 
@@ -230,6 +652,12 @@ std::vector<juce::Component*> SimpleEQAudioProcessorEditor::getComps()
         &highCutFreqSlider,
         &lowCutSlopeSlider,
         &highCutSlopeSlider,
-        &responseCurveComponent
+        &responseCurveComponent,
+        &storeAButton,
+        &storeBButton,
+        &switchABButton,
+        &morphEnabledButton,
+        &autoGainButton,
+        &morphSlider
     }; 
 }
\ No newline at end of file
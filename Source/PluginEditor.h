@@ -23,6 +23,7 @@ struct CustomRotarySlider : juce::Slider
 
 struct ResponseCurveComponent : juce::Component,
     juce::AudioProcessorParameter::Listener,
+    juce::AsyncUpdater,
     juce::Timer
 {
     ResponseCurveComponent(SimpleEQAudioProcessor&);
@@ -31,15 +32,86 @@ struct ResponseCurveComponent : juce::Component,
     //listener functions
     void parameterValueChanged(int parameterIndex, float newValue) override;
     void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override;
+    void handleAsyncUpdate() override;
     void timerCallback() override;
     void paint(juce::Graphics& g) override;
+    void resized() override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
+
+    //snapshots aren't parameters, so storing one has to be passed on by hand
+    void snapshotStored();
 
 private:
     SimpleEQAudioProcessor& audioProcessor;
     //atomic flag 
     //atomic types encapsulate a value whose access is guaranteed   
     juce::Atomic<bool> parametersChanged{ false };
-    MonoChain monoChain;
+
+    //Update rate: the timer runs at activeRateHz while parameters move,
+    //and stops once they've been still for half a second, the next change
+    //starts it again. activeRateHz adapts to how long updating and painting take
+    //it doesn't run at all while the curve isn't showing
+    static constexpr int minActiveRateHz = 15;
+    static constexpr int maxActiveRateHz = 60;
+    int activeRateHz{ maxActiveRateHz };
+    int idleTicks{ 0 };
+    double averageUpdateMs{ 0.0 };
+    void setUpdateRate(int rateHz);
+    void restartTimerIfShowing();
+    void addUpdateTime(double milliseconds);
+
+    //settings the curve shows, and the ones the cached bands were evaluated for
+    ChainSettings chainSettings, evaluatedSettings;
+    bool bandsEvaluated{ false };
+
+    //batch evaluator for the response curve
+    FilterKernels kernels{ selectFilterKernels() };
+
+    //Complex response and group delay of one band, per pixel
+    struct BandResponse
+    {
+        std::vector<double> reals, imags, groupDelays;
+    };
+
+    //LowCut, Peak and HighCut, only re-evaluated when their settings change
+    std::array<BandResponse, 3> bandResponses;
+
+    //per pixel frequencies, refilled when the width or sample rate changes
+    std::vector<double> cosOmegas, sinOmegas;
+    double gridSampleRate{ 0.0 };
+
+    //whole chain per pixel, in dB, radians and milliseconds
+    std::vector<double> mags, phases, groupDelays;
+
+    //overlays on top of the magnitude
+    juce::ToggleButton phaseButton{ "Phase" },
+        groupDelayButton{ "Group Delay" };
+
+    //Group delay axis, fitted to the delays on show and always including 0 ms
+    //rounded out to steps of 1, 2 or 5 times a power of ten, one label per step
+    float groupDelayMin{ 0.f }, groupDelayMax{ 1.f }, groupDelayStep{ 1.f };
+    void updateGroupDelayRange();
+    juce::Rectangle<int> getGroupDelayLabelArea() const;
+    void drawGroupDelayLabels(juce::Graphics& g);
+
+    //static layers, background, grid, labels and border
+    //drawn once into an image at the display's pixel scale,
+    //and thrown away when resized or moved to a display with another scale
+    juce::Image background;
+    float backgroundScale{ 1.f };
+    void renderBackground(float scale);
+
+    //curves, rebuilt only when the response or the size changes
+    //curveBounds covers all of them, so a change only repaints that area
+    juce::Path responseCurve, phaseCurve, groupDelayCurve;
+    juce::Rectangle<int> curveBounds;
+    std::vector<float> curveYs;
+    void updateCurves();
+    void refreshCurves();
+
+    void updateResponse();
+    void evaluateBand(BandResponse& band, const SectionCoefficients* sections, int numSections);
 };
 
 
@@ -73,6 +145,15 @@ private:
 
     ResponseCurveComponent responseCurveComponent;
 
+    //snapshot controls
+    juce::TextButton storeAButton{ "Store A" },
+        storeBButton{ "Store B" },
+        switchABButton{ "A/B" };
+    juce::ToggleButton morphEnabledButton{ "Morph" },
+        autoGainButton{ "Auto Gain" };
+    juce::Slider morphSlider{ juce::Slider::SliderStyle::LinearHorizontal,
+        juce::Slider::TextEntryBoxPosition::NoTextBox };
+
     using APVTS = juce::AudioProcessorValueTreeState;
     using Attachment = APVTS::SliderAttachment;
 
@@ -82,7 +163,11 @@ private:
         lowCutFreqSliderAttachment,
         highCutFreqSliderAttachment,
         lowCutSlopeSliderAttachment,
-        highCutSlopeSliderAttachment;
+        highCutSlopeSliderAttachment,
+        morphSliderAttachment;
+
+    APVTS::ButtonAttachment morphEnabledButtonAttachment,
+        autoGainButtonAttachment;
 
     //gets components
     std::vector<juce::Component*> getComps();
@@ -23,6 +23,14 @@ SimpleEQAudioProcessor::SimpleEQAudioProcessor()
                        )
 #endif
 {
+    chainParameters = getChainParameters(apvts);
+    morphParameter = apvts.getRawParameterValue("Morph");
+    morphEnabledParameter = apvts.getRawParameterValue("Morph Enabled");
+    autoGainParameter = apvts.getRawParameterValue("Auto Gain");
+
+    //every snapshot starts out as the default settings
+    snapshots.fill(getChainSettings(chainParameters));
+    morphA = morphB = snapshots.front();
 }
 
 SimpleEQAudioProcessor::~SimpleEQAudioProcessor()
@@ -64,7 +72,8 @@ bool SimpleEQAudioProcessor::isMidiEffect() const
 
 double SimpleEQAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    //worked out from the pole radii whenever the filters are designed
+    return tailLengthSeconds.load();
 }
 
 int SimpleEQAudioProcessor::getNumPrograms()
@@ -80,15 +89,18 @@ int SimpleEQAudioProcessor::getCurrentProgram()
 
 void SimpleEQAudioProcessor::setCurrentProgram (int index)
 {
+    juce::ignoreUnused(index);
 }
 
 const juce::String SimpleEQAudioProcessor::getProgramName (int index)
 {
+    juce::ignoreUnused(index);
     return {};
 }
 
 void SimpleEQAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    juce::ignoreUnused(index, newName);
 }
 
 //==============================================================================
@@ -96,20 +108,40 @@ void SimpleEQAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
 {
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
-    // Process spec object --- prepares filters before use
-    // has fields sample rate, block size, and numChannels
-    juce::dsp::ProcessSpec spec;
+    juce::ignoreUnused(samplesPerBlock);
 
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = 1;
-    spec.sampleRate = sampleRate;
+    //picks the best kernels this CPU can run
+    kernels = selectFilterKernels();
 
-    //necessary to prepare the process specs
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
+    //clear the filter states
+    for (auto& states : channelStates)
+        states.fill({});
+
+    //starts the morph where the parameter is, and forces every band to be designed
+    morphEnabled = morphEnabledParameter->load() > 0.5f;
+    morphPosition.reset(sampleRate, 0.05);
+    morphPosition.setCurrentAndTargetValue(morphParameter->load());
+    designedSampleRate = 0.0;
+
+    //no glide or crossfade left over from before
+    sourceGlide.reset(sampleRate, 0.05);
+    sourceGlide.setCurrentAndTargetValue(1.f);
+    fadePosition = fadeLength = 0;
+
+    //auto gain grid, 20 Hz to 20 kHz, kept below nyquist
+    for (int i = 0; i < numLoudnessPoints; ++i)
+    {
+        auto freq = juce::mapToLog10(double(i) / double(numLoudnessPoints - 1), 20.0, 20000.0);
+        loudnessPhis[size_t(i)] = getPhiForFrequency(juce::jmin(freq, 0.49 * sampleRate), sampleRate);
+    }
+
+    outputGain.reset(sampleRate, 0.1);
 
     //does the work of updating all audio filters
     updateFilters();
+
+    //starts at the compensation for these filters, instead of ramping to it
+    outputGain.setCurrentAndTargetValue(autoGainParameter->load() > 0.5f ? loudnessCompensation : 1.f);
 }
 
 void SimpleEQAudioProcessor::releaseResources()
@@ -148,6 +180,8 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 
 void SimpleEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    juce::ignoreUnused(midiMessages);
+
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -161,32 +195,157 @@ void SimpleEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-   
-    updateFilters();
-    
+    //picks up new snapshots, unless the message thread is storing one right now
+    auto snapshotsChanged = false;
+    {
+        const juce::SpinLock::ScopedTryLockType lock(snapshotLock);
+
+        if (lock.isLocked())
+        {
+            const auto& a = snapshots[0];
+            const auto& b = snapshots[1];
+            snapshotsChanged = lowCutDiffers(a, morphA) || peakDiffers(a, morphA) || highCutDiffers(a, morphA)
+                || lowCutDiffers(b, morphB) || peakDiffers(b, morphB) || highCutDiffers(b, morphB);
+
+            morphA = a;
+            morphB = b;
+        }
+    }
+
+    //a change of source glides from wherever the filters are now
+    const auto wasMorphEnabled = morphEnabled;
+    morphEnabled = morphEnabledParameter->load() > 0.5f;
+
+    if (morphEnabled != wasMorphEnabled || (morphEnabled && snapshotsChanged))
+    {
+        glideFrom = designedSettings;
+        sourceGlide.setCurrentAndTargetValue(0.f);
+        sourceGlide.setTargetValue(1.f);
+    }
+
+    morphPosition.setTargetValue(morphParameter->load());
+
+    //Left and right are channels 0 and 1
+    //each runs the same sections with its own filter state
+    auto numChannels = juce::jmin(totalNumInputChannels, static_cast<int>(channelStates.size()));
+    auto numSamples = buffer.getNumSamples();
+
+    //silent input into filters that have rung out can only give silence,
+    //so skip the chain and just keep the parameters moving
+    //the states are checked first, they're a few values and the input is a whole block
+    if (! isSlopeFading() && haveFiltersDecayed() && isInputSilent(buffer, numChannels))
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            buffer.clear(channel, 0, numSamples);
+
+        //clears what's left, so the chain starts from exactly nothing next time
+        for (auto& states : channelStates)
+            states.fill({});
+
+        morphPosition.skip(numSamples);
+        sourceGlide.skip(numSamples);
+        updateFilters();
+
+        //nothing is ringing, so a slope change has nothing to fade out
+        fadePosition = fadeLength;
+
+        outputGain.setTargetValue(autoGainParameter->load() > 0.5f ? loudnessCompensation : 1.f);
+        outputGain.skip(numSamples);
+        return;
+    }
 
+    for (int start = 0; start < numSamples;)
+    {
+        updateFilters();
 
+        //while the morph or a glide ramps, redesign every few samples so it moves smoothly,
+        //and crossfade a slope change a few samples at a time
+        const auto isMorphing = (morphEnabled && morphPosition.isSmoothing()) || sourceGlide.isSmoothing();
+        const auto isFading = isSlopeFading();
+        const auto length = (isMorphing || isFading) ? juce::jmin(subBlockSize, numSamples - start) : numSamples - start;
+
+        //auto gain ramps across the sub block, inside the last filter pass
+        outputGain.setTargetValue(autoGainParameter->load() > 0.5f ? loudnessCompensation : 1.f);
+        const auto startGain = outputGain.getCurrentValue();
+        const auto endGain = outputGain.skip(length);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* samples = buffer.getWritePointer(channel, start);
+
+            if (isFading)
+            {
+                std::copy(samples, samples + length, fadingSamples.begin());
+                processChannel(fadingSamples.data(), length, fadingSections, fadingStates[size_t(channel)],
+                    startGain, endGain);
+            }
+
+            processChannel(samples, length, chainSections, channelStates[size_t(channel)],
+                startGain, endGain);
+
+            //linear from the old chain to the new one
+            if (isFading)
+            {
+                for (int i = 0; i < length; ++i)
+                {
+                    const auto fade = juce::jmin(1.f, float(fadePosition + i + 1) / float(fadeLength));
+                    samples[i] = fadingSamples[size_t(i)] + fade * (samples[i] - fadingSamples[size_t(i)]);
+                }
+            }
+        }
+
+        if (isFading)
+            fadePosition += length;
+
+        morphPosition.skip(length);
+        sourceGlide.skip(length);
+        start += length;
+    }
+}
 
-    //Processing chain requires a processing context to be passed to it
-    //to make the processing context, need audio block instance
-    //Left and right are channels 0 and 1 
+bool SimpleEQAudioProcessor::isInputSilent(const juce::AudioBuffer<float>& buffer, int numChannels)
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+        if (buffer.getMagnitude(channel, 0, buffer.getNumSamples()) > silenceThreshold)
+            return false;
 
-    //want to wrap buffer in audio block
+    return true;
+}
 
-    juce::dsp::AudioBlock<float> block(buffer);
-    //wraps left and right channels
-    auto leftBlock = block.getSingleChannelBlock(0);
-    auto rightBlock = block.getSingleChannelBlock(1);
+bool SimpleEQAudioProcessor::haveFiltersDecayed() const
+{
+    //only the sections in use, a stage switched off keeps whatever state it had
+    for (auto& states : channelStates)
+    {
+        for (int i = 0; i < chainSections.numSections; ++i)
+        {
+            const auto& state = states[size_t(chainSections.slots[size_t(i)])];
 
+            if (std::abs(state.s1) > silenceThreshold || std::abs(state.s2) > silenceThreshold)
+                return false;
+        }
+    }
 
-    //Context that provides a wrapper around the blocks, that the chain can use
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+    return true;
+}
 
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+void SimpleEQAudioProcessor::processChannel(float* samples, int numSamples,
+    const ChainSections& sections,
+    std::array<SectionState, NumChainSlots>& states,
+    float startGain, float endGain)
+{
+    //the kernel wants the states packed like the sections,
+    //so gather them, run the chain, then put them back
+    std::array<SectionState, NumChainSlots> activeStates;
 
+    for (size_t i = 0; i < size_t(sections.numSections); ++i)
+        activeStates[i] = states[size_t(sections.slots[i])];
 
+    kernels.processCascade(samples, numSamples, sections.coefficients.data(),
+        activeStates.data(), sections.numSections, startGain, endGain);
+
+    for (size_t i = 0; i < size_t(sections.numSections); ++i)
+        states[size_t(sections.slots[i])] = activeStates[i];
 }
 
 //==============================================================================
@@ -204,17 +363,161 @@ juce::AudioProcessorEditor* SimpleEQAudioProcessor::createEditor()
 }
 
 //==============================================================================
+//Compact binary state, little endian, written and read field by field
+//header:  magic, version, payload size in bytes
+//payload: ChainSettings, then (version 2) Auto Gain, then (version 3) the
+//number of parameters and every parameter's value, by index into getParameters(),
+//then (version 4) the number of snapshots and each one's ChainSettings
+//later versions only append to the payload, so older readers skip what they don't know
+//and parameters are only ever appended to createParameterLayout, so indices stay put
+static constexpr int binaryStateMagic = 0x53514553; // "SEQS"
+static constexpr int binaryStateVersion = 4;
+static constexpr int binaryStateHeaderSize = 3 * sizeof(int);
+static constexpr int binaryStateChainSettingsSize = 5 * sizeof(float) + 2 * sizeof(int);
+static constexpr int binaryStateAutoGainSize = sizeof(int);
+
+using Snapshots = std::array<ChainSettings, SimpleEQAudioProcessor::numSnapshots>;
+
+static void writeChainSettings(juce::OutputStream& stream, const ChainSettings& settings)
+{
+    stream.writeFloat(settings.peakFreq);
+    stream.writeFloat(settings.peakGainInDecibels);
+    stream.writeFloat(settings.peakQuality);
+    stream.writeFloat(settings.lowCutFreq);
+    stream.writeFloat(settings.highCutFreq);
+    stream.writeInt(settings.lowCutSlope);
+    stream.writeInt(settings.highCutSlope);
+}
+
+static ChainSettings readChainSettings(juce::InputStream& stream)
+{
+    ChainSettings settings;
+    settings.peakFreq = stream.readFloat();
+    settings.peakGainInDecibels = stream.readFloat();
+    settings.peakQuality = stream.readFloat();
+    settings.lowCutFreq = stream.readFloat();
+    settings.highCutFreq = stream.readFloat();
+    settings.lowCutSlope = static_cast<Slope>(juce::jlimit<int>(Slope_12, Slope_48, stream.readInt()));
+    settings.highCutSlope = static_cast<Slope>(juce::jlimit<int>(Slope_12, Slope_48, stream.readInt()));
+    return settings;
+}
+
+static void writeBinaryState(juce::OutputStream& stream, const ChainSettings& settings, bool autoGain,
+    const juce::Array<juce::AudioProcessorParameter*>& parameters, const Snapshots& snapshots)
+{
+    const auto numParameters = parameters.size();
+    const auto numSnapshots = int(snapshots.size());
+
+    stream.writeInt(binaryStateMagic);
+    stream.writeInt(binaryStateVersion);
+    stream.writeInt(binaryStateChainSettingsSize + binaryStateAutoGainSize
+        + int(sizeof(int)) + numParameters * int(sizeof(float))
+        + int(sizeof(int)) + numSnapshots * binaryStateChainSettingsSize);
+
+    writeChainSettings(stream, settings);
+
+    stream.writeInt(autoGain ? 1 : 0);
+
+    //values as the parameters show them, so they survive a range changing
+    stream.writeInt(numParameters);
+
+    for (auto* parameter : parameters)
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        jassert(ranged != nullptr);
+        stream.writeFloat(ranged->convertFrom0to1(ranged->getValue()));
+    }
+
+    stream.writeInt(numSnapshots);
+
+    for (const auto& snapshot : snapshots)
+        writeChainSettings(stream, snapshot);
+}
+
+//returns false if the data isn't a binary state, e.g. an older ValueTree one
+//versions 1 and 2 only fill in settings and autoGain, and leave autoGain alone
+//for version 1. Version 3 fills in parameterValues with every value it holds,
+//and version 4 fills in the snapshots too, numSnapshotsRead says how many
+static bool readBinaryState(const void* data, int sizeInBytes, ChainSettings& settings, bool& autoGain,
+    juce::Array<float>& parameterValues, Snapshots& snapshots, int& numSnapshotsRead)
+{
+    parameterValues.clearQuick();
+    numSnapshotsRead = 0;
+
+    if (sizeInBytes < binaryStateHeaderSize + binaryStateChainSettingsSize)
+        return false;
+
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+
+    const auto magic = stream.readInt();
+    const auto version = stream.readInt();
+    const auto payloadSize = stream.readInt();
+
+    if (magic != binaryStateMagic
+        || version < 1
+        || payloadSize < binaryStateChainSettingsSize
+        || payloadSize > sizeInBytes - binaryStateHeaderSize)
+        return false;
+
+    settings = readChainSettings(stream);
+
+    auto remaining = payloadSize - binaryStateChainSettingsSize;
+
+    if (version < 2 || remaining < binaryStateAutoGainSize)
+        return true;
+
+    autoGain = stream.readInt() != 0;
+    remaining -= binaryStateAutoGainSize;
+
+    if (version < 3 || remaining < int(sizeof(int)))
+        return true;
+
+    const auto numParameters = stream.readInt();
+    remaining -= int(sizeof(int));
+
+    if (numParameters < 0 || numParameters > remaining / int(sizeof(float)))
+        return true;
+
+    for (int i = 0; i < numParameters; ++i)
+        parameterValues.add(stream.readFloat());
+
+    remaining -= numParameters * int(sizeof(float));
+
+    if (version < 4 || remaining < int(sizeof(int)))
+        return true;
+
+    const auto numSnapshots = stream.readInt();
+    remaining -= int(sizeof(int));
+
+    if (numSnapshots < 0 || numSnapshots > remaining / binaryStateChainSettingsSize)
+        return true;
+
+    //a state from a later version can hold more snapshots than this one has
+    numSnapshotsRead = juce::jmin(numSnapshots, int(snapshots.size()));
+
+    for (int i = 0; i < numSnapshotsRead; ++i)
+        snapshots[size_t(i)] = readChainSettings(stream);
+
+    return true;
+}
+
 void SimpleEQAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
     // You should use this method to store your parameters in the memory block.
     // You could do that either as raw data, or use the XML or ValueTree classes
     // as intermediaries to make it easy to save and load complex data.
 
+    Snapshots bank;
+    {
+        const juce::SpinLock::ScopedLockType lock(snapshotLock);
+        bank = snapshots;
+    }
 
     //this writes to the memory stream, saves state of parameters
+    //as the compact binary state rather than the whole ValueTree
     juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
-
+    writeBinaryState(mos, getChainSettings(chainParameters), autoGainParameter->load() > 0.5f,
+        getParameters(), bank);
 }
 
 void SimpleEQAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
@@ -222,102 +525,420 @@ void SimpleEQAudioProcessor::setStateInformation(const void* data, int sizeInByt
     // You should use this method to restore your parameters from this memory block,
     // whose contents will have been created by the getStateInformation() call.
 
-    //set state information
-    auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
+    //no need to update the filters here, processBlock picks the new values up
+
+    //binary state, applied straight to the parameters
+    ChainSettings settings;
+    auto autoGain = autoGainParameter->load() > 0.5f;
+    juce::Array<float> parameterValues;
+    Snapshots bank;
+    int numSnapshotsRead = 0;
+    if (readBinaryState(data, sizeInBytes, settings, autoGain, parameterValues, bank, numSnapshotsRead))
+    {
+        //snapshots go in first, so Morph Enabled coming on never morphs between stale ones
+        if (numSnapshotsRead > 0)
+        {
+            const juce::SpinLock::ScopedLockType lock(snapshotLock);
+            std::copy(bank.begin(), bank.begin() + numSnapshotsRead, snapshots.begin());
+        }
+
+        //older versions only hold the knobs and Auto Gain
+        if (parameterValues.isEmpty())
+        {
+            setChainSettings(settings);
+            apvts.getParameter("Auto Gain")->setValueNotifyingHost(autoGain ? 1.f : 0.f);
+            return;
+        }
+
+        //a state from a later version can hold parameters this one doesn't have
+        for (int i = 0; i < parameterValues.size(); ++i)
+            if (auto* parameter = dynamic_cast<juce::RangedAudioParameter*>(getParameters()[i]))
+                parameter->setValueNotifyingHost(parameter->convertTo0to1(parameterValues[i]));
+
+        return;
+    }
+
+    //sessions saved before the binary state hold the whole ValueTree
+    auto tree = juce::ValueTree::readFromData(data, size_t(sizeInBytes));
     if (tree.isValid())
     {
         apvts.replaceState(tree);
-        updateFilters();
     }
 
 }
 
+void SimpleEQAudioProcessor::setChainSettings(const ChainSettings& settings)
+{
+    auto set = [this](juce::StringRef parameterID, float value)
+    {
+        auto* parameter = apvts.getParameter(parameterID);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    };
+
+    set("Peak Freq", settings.peakFreq);
+    set("Peak Gain", settings.peakGainInDecibels);
+    set("Peak Quality", settings.peakQuality);
+    set("LowCut Freq", settings.lowCutFreq);
+    set("HighCut Freq", settings.highCutFreq);
+    set("LowCut Slope", static_cast<float>(settings.lowCutSlope));
+    set("HighCut Slope", static_cast<float>(settings.highCutSlope));
+}
+
 //==============================================================================
 // This creates new instances of the plugin..
 
+//looks up the raw parameter values by name
+ChainParameters getChainParameters(juce::AudioProcessorValueTreeState& apvts)
+{
+    ChainParameters parameters;
+
+    parameters.lowCutFreq = apvts.getRawParameterValue("LowCut Freq");
+    parameters.highCutFreq = apvts.getRawParameterValue("HighCut Freq");
+    parameters.peakFreq = apvts.getRawParameterValue("Peak Freq");
+    parameters.peakGainInDecibels = apvts.getRawParameterValue("Peak Gain");
+    parameters.peakQuality = apvts.getRawParameterValue("Peak Quality");
+    parameters.lowCutSlope = apvts.getRawParameterValue("LowCut Slope");
+    parameters.highCutSlope = apvts.getRawParameterValue("HighCut Slope");
+
+    return parameters;
+}
+
 //Chain settings struct
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
+{
+    return getChainSettings(getChainParameters(apvts));
+}
+
+ChainSettings getChainSettings(const ChainParameters& chainParameters)
 {
     ChainSettings settings;
 
     //sets the chain settings to those in the audio processor tree
-    settings.lowCutFreq = apvts.getRawParameterValue("LowCut Freq")->load();
-    settings.highCutFreq = apvts.getRawParameterValue("HighCut Freq")->load();
-    settings.peakFreq = apvts.getRawParameterValue("Peak Freq")->load();
-    settings.peakGainInDecibels = apvts.getRawParameterValue("Peak Gain")->load();
-    settings.peakQuality = apvts.getRawParameterValue("Peak Quality")->load();
-    settings.lowCutSlope = static_cast<Slope>(apvts.getRawParameterValue("LowCut Slope")->load());
-    settings.highCutSlope = static_cast<Slope>(apvts.getRawParameterValue("HighCut Slope")->load());
+    settings.lowCutFreq = chainParameters.lowCutFreq->load();
+    settings.highCutFreq = chainParameters.highCutFreq->load();
+    settings.peakFreq = chainParameters.peakFreq->load();
+    settings.peakGainInDecibels = chainParameters.peakGainInDecibels->load();
+    settings.peakQuality = chainParameters.peakQuality->load();
+    settings.lowCutSlope = static_cast<Slope>(chainParameters.lowCutSlope->load());
+    settings.highCutSlope = static_cast<Slope>(chainParameters.highCutSlope->load());
 
     return settings;
 }
 
 
-//free function to be used in processing and drawing
-Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate)
+//normalises a biquad so that a0 == 1
+static SectionCoefficients makeSection(double b0, double b1, double b2,
+    double a0, double a1, double a2)
 {
-    //returns something that makes the peak filter
-    //returns makePeakFilter, which returns a peak filter made
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,
-        chainSettings.peakFreq, chainSettings.peakQuality,
-        juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+    const auto a0Inverse = 1.0 / a0;
+
+    SectionCoefficients section;
+    section.b0 = static_cast<float>(b0 * a0Inverse);
+    section.b1 = static_cast<float>(b1 * a0Inverse);
+    section.b2 = static_cast<float>(b2 * a0Inverse);
+    section.a1 = static_cast<float>(a1 * a0Inverse);
+    section.a2 = static_cast<float>(a2 * a0Inverse);
+    return section;
 }
 
-//helper function to update Peak Filter
-void SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings& chainSettings)
+SectionCoefficients makePeakSection(const ChainSettings& chainSettings, double sampleRate)
 {
-    auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
+    //same maths as juce::dsp::IIR::Coefficients::makePeakFilter
+    const auto A = std::sqrt(juce::Decibels::decibelsToGain(double(chainSettings.peakGainInDecibels)));
+    const auto omega = juce::MathConstants<double>::twoPi
+        * juce::jmax(double(chainSettings.peakFreq), 2.0) / sampleRate;
+    const auto alpha = std::sin(omega) / (chainSettings.peakQuality * 2.0);
+    const auto c2 = -2.0 * std::cos(omega);
+
+    return makeSection(1.0 + alpha * A, c2, 1.0 - alpha * A,
+        1.0 + alpha / A, c2, 1.0 - alpha / A);
+}
+
+//butterworth cascade, one section per pair of poles
+//same maths as juce::dsp::FilterDesign's HighOrderButterworthMethod
+static CutCoefficients makeCutSections(float frequency, Slope slope,
+    double sampleRate, bool isHighPass)
+{
+    CutCoefficients sections;
+    const auto order = 2 * (slope + 1);
+
+    for (int i = 0; i < order / 2; ++i)
+    {
+        const auto Q = 1.0 / (2.0 * std::cos((2.0 * i + 1.0)
+            * juce::MathConstants<double>::pi / (order * 2.0)));
+        const auto invQ = 1.0 / Q;
+
+        if (isHighPass)
+        {
+            const auto n = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+            const auto nSquared = n * n;
+            const auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+            sections[size_t(i)] = makeSection(c1, -2.0 * c1, c1,
+                1.0, c1 * 2.0 * (nSquared - 1.0), c1 * (1.0 - invQ * n + nSquared));
+        }
+        else
+        {
+            const auto n = 1.0 / std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+            const auto nSquared = n * n;
+            const auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+            sections[size_t(i)] = makeSection(c1, 2.0 * c1, c1,
+                1.0, c1 * 2.0 * (1.0 - nSquared), c1 * (1.0 - invQ * n + nSquared));
+        }
+    }
 
-    //The chain is in the order of lowcut, peak, highcut
-    //This means that ChainPositions::Peak is accessing the second position in 
-    //the array
-    //sets coefficients in our leftChain and rightChain to the peakCoefficients returned from
-    //our previous function call
-    updateCoefficients(leftChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    updateCoefficients(rightChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+    return sections;
 }
 
-//This is now a free function
-void updateCoefficients(Coefficients& old, const Coefficients &replacements)
+CutCoefficients makeLowCutSections(const ChainSettings& chainSettings, double sampleRate)
 {
-    *old = *replacements;
+    return makeCutSections(chainSettings.lowCutFreq, chainSettings.lowCutSlope, sampleRate, true);
 }
 
-void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings& chainSettings)
+CutCoefficients makeHighCutSections(const ChainSettings& chainSettings, double sampleRate)
+{
+    return makeCutSections(chainSettings.highCutFreq, chainSettings.highCutSlope, sampleRate, false);
+}
+
+ChainSections makeChainSections(const CutCoefficients& lowCut, Slope lowCutSlope,
+    const SectionCoefficients& peak,
+    const CutCoefficients& highCut, Slope highCutSlope)
+{
+    ChainSections chain;
+
+    auto add = [&chain](const SectionCoefficients& section, int slot)
+    {
+        chain.coefficients[size_t(chain.numSections)] = section;
+        chain.slots[size_t(chain.numSections)] = slot;
+        ++chain.numSections;
+    };
+
+    for (int i = 0; i <= lowCutSlope; ++i)
+        add(lowCut[size_t(i)], LowCutSlot + i);
+
+    add(peak, PeakSlot);
+
+    for (int i = 0; i <= highCutSlope; ++i)
+        add(highCut[size_t(i)], HighCutSlot + i);
+
+    return chain;
+}
+
+ChainSections makeChainSections(const ChainSettings& chainSettings, double sampleRate)
 {
-    //makes a lowcutfilter with our chain settings and sample rate, gets coefficients
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, getSampleRate());
+    return makeChainSections(makeLowCutSections(chainSettings, sampleRate), chainSettings.lowCutSlope,
+        makePeakSection(chainSettings, sampleRate),
+        makeHighCutSections(chainSettings, sampleRate), chainSettings.highCutSlope);
+}
 
-    //gets reference to the low cut processor
-    auto& leftLowCut = leftChain.get<ChainPositions::LowCut>();
-    
-    //updates the cut filter of leftLowCut (old in chain) to new (lowCutCoefficients)
-    updateCutFilter(leftLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
-    auto& rightLowCut = rightChain.get<ChainPositions::LowCut>();
-    updateCutFilter(rightLowCut, lowCutCoefficients, chainSettings.lowCutSlope);
+//helper function to update Peak Filter
+void SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings& chainSettings)
+{
+    peakSection = makePeakSection(chainSettings, getSampleRate());
 }
+
+void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings& chainSettings)
+{
+    //makes the low cut sections with our chain settings and sample rate
+    lowCutSections = makeLowCutSections(chainSettings, getSampleRate());
+}
+
 void SimpleEQAudioProcessor::updateHighCutFilters(const ChainSettings& chainSettings)
 {
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, getSampleRate());
-    auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-    updateCutFilter(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-    auto& rightHighCut = rightChain.get<ChainPositions::HighCut>();
-    updateCutFilter(rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
+    highCutSections = makeHighCutSections(chainSettings, getSampleRate());
 }
 
 void SimpleEQAudioProcessor::updateFilters()
 {
-    auto chainSettings = getChainSettings(apvts);
+    //the snapshots drive the filters while morphing is on, the knobs otherwise
+    auto settings = morphEnabled ? morphChainSettings(morphA, morphB, morphPosition.getCurrentValue())
+                                 : getChainSettings(chainParameters);
 
-    updateLowCutFilters(chainSettings);
-    updatePeakFilter(chainSettings);
-    updateHighCutFilters(chainSettings);
+    if (sourceGlide.isSmoothing())
+        settings = morphChainSettings(glideFrom, settings, sourceGlide.getCurrentValue());
+
+    updateFilters(settings);
+}
+
+void SimpleEQAudioProcessor::updateFilters(const ChainSettings& newSettings)
+{
+    //a new sample rate means every band has to be designed again
+    const auto redesignAll = ! isSameValue(designedSampleRate, getSampleRate());
+
+    //slopes stay put until the last change has faded in
+    auto chainSettings = newSettings;
+    if (isSlopeFading())
+    {
+        chainSettings.lowCutSlope = designedSettings.lowCutSlope;
+        chainSettings.highCutSlope = designedSettings.highCutSlope;
+    }
+
+    const auto lowCutChanged = redesignAll || lowCutDiffers(chainSettings, designedSettings);
+    const auto peakChanged = redesignAll || peakDiffers(chainSettings, designedSettings);
+    const auto highCutChanged = redesignAll || highCutDiffers(chainSettings, designedSettings);
+
+    if (! (lowCutChanged || peakChanged || highCutChanged))
+        return;
+
+    if (lowCutChanged)
+        updateLowCutFilters(chainSettings);
+    if (peakChanged)
+        updatePeakFilter(chainSettings);
+    if (highCutChanged)
+        updateHighCutFilters(chainSettings);
+
+    //the chain about to be replaced fades out from where it is
+    if (! redesignAll && (chainSettings.lowCutSlope != designedSettings.lowCutSlope
+                          || chainSettings.highCutSlope != designedSettings.highCutSlope))
+    {
+        fadingSections = chainSections;
+        fadingStates = channelStates;
+        fadePosition = 0;
+        fadeLength = juce::jmax(1, juce::roundToInt(0.02 * getSampleRate()));
+    }
+
+    designedSettings = chainSettings;
+    designedSampleRate = getSampleRate();
+
+    //packs the sections processBlock runs
+    chainSections = makeChainSections(lowCutSections, chainSettings.lowCutSlope,
+        peakSection,
+        highCutSections, chainSettings.highCutSlope);
+
+    //only re-estimated here, when the sections actually changed
+    loudnessCompensation = estimateLoudnessCompensation();
+    tailLengthSeconds.store(getChainDecaySamples(chainSections) / getSampleRate());
+}
+
+//samples until the impulse response of a section falls by 100 dB,
+//worked out from the radius of its poles
+static double getDecaySamples(const SectionCoefficients& section)
+{
+    //a peak at 0 dB has its zeros right on its poles, so it doesn't ring at all
+    if (isSameValue(section.b0, 1.f) && isSameValue(section.b1, section.a1) && isSameValue(section.b2, section.a2))
+        return 0.0;
+
+    //poles are the roots of z^2 + a1 z + a2
+    const double a1 = section.a1, a2 = section.a2;
+    const auto discriminant = a1 * a1 - 4.0 * a2;
+
+    double radius;
+    if (discriminant < 0.0)
+    {
+        //complex pair, both with radius sqrt(a2)
+        radius = std::sqrt(a2);
+    }
+    else
+    {
+        const auto root = std::sqrt(discriminant);
+        radius = 0.5 * juce::jmax(std::abs(-a1 + root), std::abs(-a1 - root));
+    }
+
+    //no poles left inside, just the two delays
+    if (radius <= 0.0)
+        return 2.0;
+
+    //never decays
+    if (radius >= 1.0)
+        return std::numeric_limits<double>::infinity();
+
+    //-100 dB is decibelsToGain's default floor, below which it gives 0
+    return std::log(juce::Decibels::decibelsToGain(-100.0, -200.0)) / std::log(radius) + 2.0;
+}
+
+double getChainDecaySamples(const ChainSections& chainSections)
+{
+    //the slowest poles dominate how long the whole cascade rings,
+    //adding the sections' decays up would overstate it several times over
+    double samples = 0.0;
+
+    for (int i = 0; i < chainSections.numSections; ++i)
+        samples = juce::jmax(samples, getDecaySamples(chainSections.coefficients[size_t(i)]));
+
+    return samples;
+}
+
+float SimpleEQAudioProcessor::estimateLoudnessCompensation()
+{
+    //mean power of the response over log frequency, i.e. weighted like pink noise,
+    //using the same evaluator the response curve is drawn with
+    loudnessMagnitudes.fill(1.0);
+    kernels.evaluateMagnitudes(loudnessPhis.data(), loudnessMagnitudes.data(), numLoudnessPoints,
+        chainSections.coefficients.data(), chainSections.numSections);
+
+    double power = 0.0;
+    for (auto magnitude : loudnessMagnitudes)
+        power += magnitude * magnitude;
+
+    power /= numLoudnessPoints;
+
+    //the gain that brings the mean power back to unity, within the peak gain range
+    const auto compensation = 1.0 / std::sqrt(juce::jmax(power, 1.0e-12));
+    return static_cast<float>(juce::jlimit(juce::Decibels::decibelsToGain(-24.0),
+        juce::Decibels::decibelsToGain(24.0), compensation));
+}
+
+bool lowCutDiffers(const ChainSettings& a, const ChainSettings& b)
+{
+    return ! isSameValue(a.lowCutFreq, b.lowCutFreq) || a.lowCutSlope != b.lowCutSlope;
+}
+
+bool peakDiffers(const ChainSettings& a, const ChainSettings& b)
+{
+    return ! isSameValue(a.peakFreq, b.peakFreq)
+        || ! isSameValue(a.peakGainInDecibels, b.peakGainInDecibels)
+        || ! isSameValue(a.peakQuality, b.peakQuality);
+}
+
+bool highCutDiffers(const ChainSettings& a, const ChainSettings& b)
+{
+    return ! isSameValue(a.highCutFreq, b.highCutFreq) || a.highCutSlope != b.highCutSlope;
+}
+
+ChainSettings morphChainSettings(const ChainSettings& a, const ChainSettings& b, float position)
+{
+    //from * (to / from)^position is exactly from when both are equal
+    auto logLerp = [position](float from, float to) { return from * std::pow(to / from, position); };
+    auto lerp = [position](float from, float to) { return from + (to - from) * position; };
+
+    ChainSettings settings;
+    settings.peakFreq = logLerp(a.peakFreq, b.peakFreq);
+    settings.peakGainInDecibels = lerp(a.peakGainInDecibels, b.peakGainInDecibels);
+    settings.peakQuality = logLerp(a.peakQuality, b.peakQuality);
+    settings.lowCutFreq = logLerp(a.lowCutFreq, b.lowCutFreq);
+    settings.highCutFreq = logLerp(a.highCutFreq, b.highCutFreq);
+
+    //slopes can't be blended
+    settings.lowCutSlope = position < 0.5f ? a.lowCutSlope : b.lowCutSlope;
+    settings.highCutSlope = position < 0.5f ? a.highCutSlope : b.highCutSlope;
+
+    return settings;
+}
+
+void SimpleEQAudioProcessor::storeSnapshot(int slot)
+{
+    jassert(juce::isPositiveAndBelow(slot, numSnapshots));
+
+    const auto settings = getChainSettings(chainParameters);
+    const juce::SpinLock::ScopedLockType lock(snapshotLock);
+    snapshots[size_t(slot)] = settings;
+}
+
+ChainSettings SimpleEQAudioProcessor::getTargetChainSettings() const
+{
+    if (morphEnabledParameter->load() <= 0.5f)
+        return getChainSettings(chainParameters);
+
+    const juce::SpinLock::ScopedLockType lock(snapshotLock);
+    return morphChainSettings(snapshots[0], snapshots[1], morphParameter->load());
 }
 
 
 juce::AudioProcessorValueTreeState::ParameterLayout
 SimpleEQAudioProcessor::createParameterLayout()
 {
+    //the binary state stores parameters by index, so new ones go at the end
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
 
     layout.add(std::make_unique<juce::AudioParameterFloat>("LowCut Freq",
@@ -353,6 +974,16 @@ SimpleEQAudioProcessor::createParameterLayout()
     layout.add(std::make_unique <juce::AudioParameterChoice>("LowCut Slope", "LowCut Slope", stringArray, 0));
     layout.add(std::make_unique <juce::AudioParameterChoice>("HighCut Slope", "HighCut Slope", stringArray, 0));
 
+    //position between snapshots A and B, and whether they drive the filters
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Morph",
+        "Morph", juce::NormalisableRange<float>(0.f, 1.f, 0.001f, 1.f),
+        0.f));
+
+    layout.add(std::make_unique<juce::AudioParameterBool>("Morph Enabled", "Morph Enabled", false));
+
+    //compensates the loudness change of the EQ curve
+    layout.add(std::make_unique<juce::AudioParameterBool>("Auto Gain", "Auto Gain", false));
+
     return layout;
 }
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "FilterKernels.h"
 
 
 enum Slope
@@ -31,105 +32,80 @@ struct ChainSettings
     Slope highCutSlope{ Slope::Slope_12 };
 };
 
+//Pointers to the raw parameter values behind ChainSettings
+//looked up once, so reading the settings on the audio thread is
+//just atomic loads instead of a lookup by name per parameter
+struct ChainParameters
+{
+    std::atomic<float>* peakFreq{ nullptr };
+    std::atomic<float>* peakGainInDecibels{ nullptr };
+    std::atomic<float>* peakQuality{ nullptr };
+    std::atomic<float>* lowCutFreq{ nullptr };
+    std::atomic<float>* highCutFreq{ nullptr };
+    std::atomic<float>* lowCutSlope{ nullptr };
+    std::atomic<float>* highCutSlope{ nullptr };
+};
+
+//Function to look up the parameter pointers
+ChainParameters getChainParameters(juce::AudioProcessorValueTreeState& apvts);
+
 //Function to get chain settings
 //returns AudioProcessorValueTreeState
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
 
-//define chains
-//pass in processing contexts, which will run through chain automatically
-//aliases are useful for nested namespaces
-using Filter = juce::dsp::IIR::Filter<float>;
+//same as above, from pointers looked up beforehand
+ChainSettings getChainSettings(const ChainParameters& chainParameters);
 
-//Cut filter is made
-//using a chain of multiple filters stacked on each other
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
+//whether a band needs redesigning when going from one settings to another
+bool lowCutDiffers(const ChainSettings& a, const ChainSettings& b);
+bool peakDiffers(const ChainSettings& a, const ChainSettings& b);
+bool highCutDiffers(const ChainSettings& a, const ChainSettings& b);
 
-//Can uses filters in notch, peaks, shelfs, etc.
-//Monochain is Lowcut -> Parametric -> HighCut, this is the whole signal chain
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
+//settings part way between two snapshots, position 0 is a, 1 is b
+//frequencies and Q move on a log scale, gain in dB, slopes switch halfway
+//bands that are the same in both come out exactly the same
+ChainSettings morphChainSettings(const ChainSettings& a, const ChainSettings& b, float position);
 
-//Enumeration for ease of accessing
-//each element in the chain
-enum ChainPositions
+//one section per stage of a cut filter, enough for Slope_48
+using CutCoefficients = std::array<SectionCoefficients, 4>;
+
+//Where each section lives in the whole signal chain
+//Lowcut -> Parametric -> HighCut
+enum ChainSlots
 {
-    LowCut,
-    Peak,
-    HighCut
+    LowCutSlot = 0,
+    PeakSlot = 4,
+    HighCutSlot = 5,
+    NumChainSlots = 9
 };
 
-//Alias for Filter's Coefficients
-using Coefficients = Filter::CoefficientsPtr;
-
-//Function to update coefficients
-void updateCoefficients(Coefficients& old, const Coefficients& replacements);
+//The sections the chain actually runs, in processing order
+//bypassed cut stages are left out, slots says which ChainSlot each one is
+struct ChainSections
+{
+    std::array<SectionCoefficients, NumChainSlots> coefficients;
+    std::array<int, NumChainSlots> slots{};
+    int numSections{ 0 };
+};
 
-//function to make peak filter.
-Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate);
+//allocation-free designers, safe to use on the audio thread
+//they match juce::dsp::IIR::Coefficients::makePeakFilter and
+//juce::dsp::FilterDesign's butterworth method
+SectionCoefficients makePeakSection(const ChainSettings& chainSettings, double sampleRate);
+CutCoefficients makeLowCutSections(const ChainSettings& chainSettings, double sampleRate);
+CutCoefficients makeHighCutSections(const ChainSettings& chainSettings, double sampleRate);
 
-//helper function
-//updates coefficients on a chain, unbypasses
-//ChainType can be 
-template<int Index, typename ChainType, typename CoefficientType>
-void update(ChainType& chain, const CoefficientType& coefficients)
-{
-    updateCoefficients(chain.template get<Index>().coefficients,
-        coefficients[Index]);
-    chain.template setBypassed<Index>(false);
-}
-
-
-//templates have generic types
-//updates cutfilter
-//refactored so variable names make more sense
-template<typename ChainType, typename CoefficientType>
-void updateCutFilter(ChainType& cutChain,
-    const CoefficientType& cutCoefficients,
-    const Slope& lowCutSlope)
-{
-    //the chain is a processor chain,
-    //this bypasses the ith element in the chain
-    cutChain.template setBypassed<0>(true);
-    cutChain.template setBypassed<1>(true);
-    cutChain.template setBypassed<2>(true);
-    cutChain.template setBypassed<3>(true);
-
-    switch (lowCutSlope)
-    {
-    case Slope_48:
-    {
-        update<3>(cutChain, cutCoefficients);
-    }
-    case Slope_36:
-    {
-        update<2>(cutChain, cutCoefficients);
-    }
-    case Slope_24:
-    {
-        update<1>(cutChain, cutCoefficients);
-    }
-    case Slope_12:
-    {
-        update<0>(cutChain, cutCoefficients);
-    }
-    }
-}
-
-
-//necessary inline
-inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate)
-{
-    //arguments: frequency, sample rate, order
-    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq,
-            sampleRate, 2 * (chainSettings.lowCutSlope + 1));
-}
+//packs the sections in use, Slope_12 uses the first cut section, Slope_48 all four
+ChainSections makeChainSections(const CutCoefficients& lowCut, Slope lowCutSlope,
+    const SectionCoefficients& peak,
+    const CutCoefficients& highCut, Slope highCutSlope);
 
+//designs and packs the whole chain
+ChainSections makeChainSections(const ChainSettings& chainSettings, double sampleRate);
 
-//necessary inline
-inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate)
-{
-    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq,
-        sampleRate, 2 * (chainSettings.highCutSlope + 1));
-}
+//samples the chain keeps ringing for until it's 100 dB down,
+//worked out from the pole radii of its sections
+double getChainDecaySamples(const ChainSections& chainSections);
 
 //==============================================================================
 /**
@@ -174,6 +150,20 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //sets every parameter from the settings, without touching the ValueTree
+    void setChainSettings(const ChainSettings& settings);
+
+    //Snapshot bank, slot 0 is A and slot 1 is B, the Morph parameter moves
+    //between them and Morph Enabled decides if they or the knobs drive the filters
+    static constexpr int numSnapshots = 2;
+
+    //stores the current knob settings in a slot
+    void storeSnapshot(int slot);
+
+    //settings the filters are heading for, the knobs or the morph
+    //between the snapshots, for drawing on the message thread
+    ChainSettings getTargetChainSettings() const;
+
 
     // audio processor value tree state
     //need all parameters laid out before the tree is created
@@ -184,14 +174,83 @@ public:
 
 
 private:
-    //left and right audio chains
-    MonoChain leftChain, rightChain;
+    //kernels for this machine, picked in prepareToPlay
+    FilterKernels kernels{ getFilterKernels(Kernel_Generic) };
+
+    //designed sections of each band
+    CutCoefficients lowCutSections, highCutSections;
+    SectionCoefficients peakSection;
+
+    //what processBlock runs, rebuilt by updateFilters
+    ChainSections chainSections;
+
+    //left and right filter states, indexed by ChainSlots
+    //so a stage keeps its state while its slope is switched off
+    std::array<std::array<SectionState, NumChainSlots>, 2> channelStates;
+
+    //cached so processBlock never looks parameters up by name
+    ChainParameters chainParameters;
+    std::atomic<float>* morphParameter{ nullptr };
+    std::atomic<float>* morphEnabledParameter{ nullptr };
+
+    //settings and sample rate the current sections were designed for
+    //bands that haven't changed since are not redesigned
+    ChainSettings designedSettings;
+    double designedSampleRate{ 0.0 };
+
+    //the bank, written by the message thread
+    //the audio thread only tries the lock, and keeps its copies if it's busy
+    std::array<ChainSettings, numSnapshots> snapshots;
+    juce::SpinLock snapshotLock;
+
+    //audio thread copies of snapshots A and B, and Morph Enabled as this block sees it
+    ChainSettings morphA, morphB;
+    bool morphEnabled{ false };
+
+    //ramps the morph, so A/B switches and jumps of the parameter don't click
+    juce::SmoothedValue<float> morphPosition;
+
+    //Glide, when the filters change source, Morph Enabled toggling or a snapshot
+    //being stored into A or B, they move from the settings they had to the new ones
+    ChainSettings glideFrom;
+    juce::SmoothedValue<float> sourceGlide;
+
+    //Slope crossfade, a slope change adds or removes whole sections, so the old
+    //chain keeps running on its own copy of the states and fades out
+    //further slope changes wait until the fade is over
+    static constexpr int subBlockSize = 32;
+    ChainSections fadingSections;
+    std::array<std::array<SectionState, NumChainSlots>, 2> fadingStates;
+    std::array<float, subBlockSize> fadingSamples;
+    int fadePosition{ 0 }, fadeLength{ 0 };
+    bool isSlopeFading() const { return fadePosition < fadeLength; }
+
+    //Auto gain, evaluates the response on a fixed log spaced grid
+    //whenever the sections change and compensates its loudness
+    static constexpr int numLoudnessPoints = 64;
+    std::array<double, numLoudnessPoints> loudnessPhis, loudnessMagnitudes;
+    std::atomic<float>* autoGainParameter{ nullptr };
+    float loudnessCompensation{ 1.f };
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> outputGain;
+    float estimateLoudnessCompensation();
+
+    //Tail and silence, the tail is reported to the host, and silent input
+    //into filters whose states have decayed skips the chain altogether
+    static constexpr float silenceThreshold = 1.0e-6f;
+    std::atomic<double> tailLengthSeconds{ 0.0 };
+    static bool isInputSilent(const juce::AudioBuffer<float>& buffer, int numChannels);
+    bool haveFiltersDecayed() const;
 
     //Refactoring using helper functions
     void updatePeakFilter(const ChainSettings& chainSettings);
     void updateLowCutFilters(const ChainSettings& chainSettings);
     void updateHighCutFilters(const ChainSettings& chainSettings);
     void updateFilters();
+    void updateFilters(const ChainSettings& chainSettings);
+    void processChannel(float* samples, int numSamples,
+        const ChainSections& sections,
+        std::array<SectionState, NumChainSlots>& states,
+        float startGain, float endGain);
  
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SimpleEQAudioProcessor)
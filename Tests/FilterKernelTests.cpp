@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    Every kernel variant this build and CPU can run must give the same
+    answer as the generic kernels, otherwise picking one is a bug.
+
+  ==============================================================================
+*/
+
+#include "../Source/FilterKernels.h"
+
+struct FilterKernelTests : juce::UnitTest
+{
+    FilterKernelTests() : juce::UnitTest("FilterKernels", "SimpleEQ") {}
+
+    static constexpr int numSamples = 64;
+    static constexpr int numPoints = 16;
+
+    //a resonant section and a low pass one, both stable
+    static constexpr SectionCoefficients sections[] = { { 0.9f, -1.7f, 0.8f, -1.8f, 0.82f },
+                                                        { 0.2f, 0.4f, 0.2f, -0.5f, 0.3f } };
+    static constexpr int numSections = 2;
+
+    static bool isClose(double value, double expected)
+    {
+        return std::abs(value - expected) <= 1.0e-6 * std::abs(expected) + 1.0e-9;
+    }
+
+    void runTest() override
+    {
+        const auto generic = getFilterKernels(Kernel_Generic);
+
+        for (int v = 0; v < NumKernelVariants; ++v)
+        {
+            const auto variant = static_cast<KernelVariant>(v);
+            if (variant == Kernel_Generic || ! isKernelVariantSupported(variant))
+                continue;
+
+            beginTest(juce::String(getKernelVariantName(variant)) + " agrees with generic");
+
+            const auto kernels = getFilterKernels(variant);
+            expect(kernels.variant == variant, "getFilterKernels returned another variant");
+
+            checkProcessCascade(generic, kernels);
+            checkEvaluateMagnitudes(generic, kernels);
+            checkEvaluateResponse(generic, kernels);
+        }
+    }
+
+    //an impulse through both sections, with the gain ramping down
+    void checkProcessCascade(const FilterKernels& generic, const FilterKernels& kernels)
+    {
+        float expected[numSamples] = { 1.f };
+        SectionState expectedStates[numSections];
+        generic.processCascade(expected, numSamples, sections, expectedStates, numSections, 1.f, 0.5f);
+
+        float samples[numSamples] = { 1.f };
+        SectionState states[numSections];
+        kernels.processCascade(samples, numSamples, sections, states, numSections, 1.f, 0.5f);
+
+        auto worstError = 0.f;
+        for (int i = 0; i < numSamples; ++i)
+            worstError = juce::jmax(worstError, std::abs(samples[i] - expected[i]));
+
+        expect(worstError <= 1.0e-4f, "processCascade is off by " + juce::String(worstError));
+    }
+
+    void checkEvaluateMagnitudes(const FilterKernels& generic, const FilterKernels& kernels)
+    {
+        double phis[numPoints], expected[numPoints], magnitudes[numPoints];
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            phis[i] = i / double(numPoints - 1);
+            expected[i] = magnitudes[i] = 1.0;
+        }
+
+        generic.evaluateMagnitudes(phis, expected, numPoints, sections, numSections);
+        kernels.evaluateMagnitudes(phis, magnitudes, numPoints, sections, numSections);
+
+        for (int i = 0; i < numPoints; ++i)
+            expect(isClose(magnitudes[i], expected[i]), "evaluateMagnitudes differs at point " + juce::String(i));
+    }
+
+    void checkEvaluateResponse(const FilterKernels& generic, const FilterKernels& kernels)
+    {
+        double cosOmegas[numPoints], sinOmegas[numPoints];
+        double expectedReals[numPoints], expectedImags[numPoints], expectedDelays[numPoints];
+        double reals[numPoints], imags[numPoints], delays[numPoints];
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const auto omega = juce::MathConstants<double>::pi * i / double(numPoints);
+            cosOmegas[i] = std::cos(omega);
+            sinOmegas[i] = std::sin(omega);
+            expectedReals[i] = reals[i] = 1.0;
+            expectedImags[i] = imags[i] = 0.0;
+            expectedDelays[i] = delays[i] = 0.0;
+        }
+
+        generic.evaluateResponse(cosOmegas, sinOmegas, expectedReals, expectedImags, expectedDelays,
+            numPoints, sections, numSections);
+        kernels.evaluateResponse(cosOmegas, sinOmegas, reals, imags, delays,
+            numPoints, sections, numSections);
+
+        for (int i = 0; i < numPoints; ++i)
+            expect(isClose(reals[i], expectedReals[i])
+                && isClose(imags[i], expectedImags[i])
+                && isClose(delays[i], expectedDelays[i]),
+                "evaluateResponse differs at point " + juce::String(i));
+    }
+};
+
+static FilterKernelTests filterKernelTests;
@@ -0,0 +1,690 @@
+/*
+  ==============================================================================
+
+    Runs SimpleEQAudioProcessor without a host: automation sweeps over every
+    parameter compared against golden renders, with every processBlock call
+    checked for allocations and locks.
+
+  ==============================================================================
+*/
+
+#include "../Source/PluginProcessor.h"
+#include "ReferenceChain.h"
+#include "RealtimeChecks.h"
+
+//settings the sweeps start from, with all three bands doing something
+static ChainSettings getBaseSettings()
+{
+    ChainSettings settings;
+    settings.lowCutFreq = 80.f;
+    settings.lowCutSlope = Slope_24;
+    settings.peakFreq = 1000.f;
+    settings.peakGainInDecibels = 6.f;
+    settings.peakQuality = 2.f;
+    settings.highCutFreq = 12000.f;
+    settings.highCutSlope = Slope_36;
+    return settings;
+}
+
+//settings far away from the base ones, for snapshot B
+static ChainSettings getOtherSettings()
+{
+    ChainSettings settings;
+    settings.lowCutFreq = 200.f;
+    settings.lowCutSlope = Slope_48;
+    settings.peakFreq = 300.f;
+    settings.peakGainInDecibels = -12.f;
+    settings.peakQuality = 0.7f;
+    settings.highCutFreq = 5000.f;
+    settings.highCutSlope = Slope_12;
+    return settings;
+}
+
+struct ProcessorTests : juce::UnitTest
+{
+    ProcessorTests() : juce::UnitTest("SimpleEQAudioProcessor", "SimpleEQ") {}
+
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+    static constexpr int numBlocks = 128;
+
+    //largest difference from the golden render, relative to the block's peak
+    //juce designs its coefficients in float, so near 20 Hz their rounding
+    //alone moves a narrow peak by about 1e-3
+    static constexpr float tolerance = 2.0e-3f;
+
+    //how sweeping a parameter should change the golden render
+    enum Expectation
+    {
+        FollowsChain,
+        NoEffect,
+        ScalesByAutoGain,
+        Unknown
+    };
+
+    static Expectation getExpectation(const juce::String& parameterID)
+    {
+        for (auto* chainParameterID : { "LowCut Freq", "HighCut Freq", "Peak Freq", "Peak Gain",
+                                        "Peak Quality", "LowCut Slope", "HighCut Slope" })
+            if (parameterID == chainParameterID)
+                return FollowsChain;
+
+        //snapshots A and B both hold the knob settings during the sweeps
+        if (parameterID == "Morph" || parameterID == "Morph Enabled")
+            return NoEffect;
+
+        if (parameterID == "Auto Gain")
+            return ScalesByAutoGain;
+
+        return Unknown;
+    }
+
+    //equal up to the rounding of going through a parameter's normalised range
+    static bool isClose(float value, float expected)
+    {
+        return std::abs(value - expected) <= 1.0e-4f * juce::jmax(1.f, std::abs(expected));
+    }
+
+    static void prepare(SimpleEQAudioProcessor& processor)
+    {
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+
+    static void fillWithNoise(juce::AudioBuffer<float>& buffer, juce::Random& random, float level)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(channel, i, level * (2.f * random.nextFloat() - 1.f));
+    }
+
+    void runTest() override
+    {
+        if (! canDetectLocks())
+            logMessage("Locks on the audio thread can't be detected on this platform, only allocations are checked");
+
+        //every parameter createParameterLayout makes, so new ones can't be missed
+        SimpleEQAudioProcessor layout;
+
+        for (auto* parameter : layout.getParameters())
+        {
+            const auto parameterID = dynamic_cast<juce::RangedAudioParameter&>(*parameter).getParameterID();
+
+            beginTest("Sweep " + parameterID);
+            runSweep(parameterID);
+        }
+
+        beginTest("Auto Gain on from the first block");
+        runAutoGainFromStart();
+
+        beginTest("Morphing, snapshots, state loads and silence");
+        runMorphAndSilence();
+
+        beginTest("Tail of a 20 Hz Slope_48 low cut");
+        runLowCutTail();
+
+        beginTest("Changes of source and slope don't click");
+        runTransitions();
+
+        beginTest("State round trip");
+        runStateRoundTrip();
+
+        beginTest("State round trip while morphing");
+        runMorphStateRoundTrip();
+
+        beginTest("Loading a ValueTree state");
+        runValueTreeStateLoad();
+
+        beginTest("Loading a version 2 state");
+        runVersion2StateLoad();
+    }
+
+    //ramps one parameter across its whole range, one step per block,
+    //and compares every block with the golden render of the same settings
+    void runSweep(const juce::String& parameterID)
+    {
+        const auto expectation = getExpectation(parameterID);
+
+        if (expectation == Unknown)
+        {
+            expect(false, parameterID + " has no expected effect, add it to getExpectation");
+            return;
+        }
+
+        SimpleEQAudioProcessor processor;
+        processor.setChainSettings(getBaseSettings());
+        processor.storeSnapshot(0);
+        processor.storeSnapshot(1);
+        prepare(processor);
+
+        ReferenceChain reference;
+        reference.prepare(sampleRate, blockSize);
+
+        auto* parameter = processor.apvts.getParameter(parameterID);
+
+        juce::AudioBuffer<float> buffer(2, blockSize), expected(2, blockSize);
+        juce::MidiBuffer midiMessages;
+        juce::Random random(0x5eed);
+
+        auto previousSettings = getChainSettings(processor.apvts);
+        auto autoGain = 1.f;
+        auto autoGainWasOn = false;
+
+        //slope changes crossfade, and auto gain ramps, so the blocks
+        //right after them don't follow the golden render sample for sample
+        const auto autoGainBlocks = int(std::ceil(0.1 * sampleRate / blockSize)) + 1;
+        int blocksToSkip = 0;
+
+        RealtimeViolations violations;
+        auto worstError = 0.f;
+        int worstBlock = -1;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            //automation arrives between blocks, like a host sends it
+            parameter->setValueNotifyingHost(float(block) / float(numBlocks - 1));
+
+            const auto settings = getChainSettings(processor.apvts);
+
+            if (settings.lowCutSlope != previousSettings.lowCutSlope
+                || settings.highCutSlope != previousSettings.highCutSlope)
+                blocksToSkip = 2;
+
+            previousSettings = settings;
+
+            if (expectation == ScalesByAutoGain)
+            {
+                const auto autoGainIsOn = parameter->getValue() > 0.5f;
+
+                if (autoGainIsOn != autoGainWasOn)
+                {
+                    autoGain = autoGainIsOn ? ReferenceChain::getLoudnessCompensation(settings, sampleRate) : 1.f;
+                    autoGainWasOn = autoGainIsOn;
+                    blocksToSkip = autoGainBlocks;
+                }
+            }
+
+            fillWithNoise(buffer, random, 0.25f);
+            expected.makeCopyOf(buffer, true);
+
+            reference.update(settings);
+            reference.process(expected);
+            expected.applyGain(autoGain);
+
+            beginRealtimeCheck();
+            processor.processBlock(buffer, midiMessages);
+            const auto blockViolations = endRealtimeCheck();
+
+            violations.allocations += blockViolations.allocations;
+            violations.deallocations += blockViolations.deallocations;
+            violations.locks += blockViolations.locks;
+
+            if (blocksToSkip > 0)
+            {
+                --blocksToSkip;
+                continue;
+            }
+
+            const auto scale = juce::jmax(0.25f, expected.getMagnitude(0, blockSize));
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const auto error = std::abs(buffer.getSample(channel, i) - expected.getSample(channel, i)) / scale;
+
+                    if (error > worstError)
+                    {
+                        worstError = error;
+                        worstBlock = block;
+                    }
+                }
+            }
+        }
+
+        expect(! violations.any(), "processBlock made " + describeRealtimeViolations(violations));
+        expect(worstError <= tolerance, "block " + juce::String(worstBlock)
+            + " is off the golden render by " + juce::String(worstError));
+    }
+
+    //with Auto Gain already on, the very first block is compensated,
+    //instead of ramping from unity after prepareToPlay
+    void runAutoGainFromStart()
+    {
+        const auto settings = getBaseSettings();
+
+        SimpleEQAudioProcessor processor;
+        processor.setChainSettings(settings);
+        processor.apvts.getParameter("Auto Gain")->setValueNotifyingHost(1.f);
+        prepare(processor);
+
+        ReferenceChain reference;
+        reference.prepare(sampleRate, blockSize);
+        reference.update(settings);
+
+        juce::AudioBuffer<float> buffer(2, blockSize), expected(2, blockSize);
+        juce::MidiBuffer midiMessages;
+        juce::Random random(0x9a1);
+
+        fillWithNoise(buffer, random, 0.25f);
+        expected.makeCopyOf(buffer, true);
+
+        reference.process(expected);
+        expected.applyGain(ReferenceChain::getLoudnessCompensation(settings, sampleRate));
+        processor.processBlock(buffer, midiMessages);
+
+        const auto scale = juce::jmax(0.25f, expected.getMagnitude(0, blockSize));
+        auto worstError = 0.f;
+
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < blockSize; ++i)
+                worstError = juce::jmax(worstError, std::abs(buffer.getSample(channel, i) - expected.getSample(channel, i)) / scale);
+
+        expect(worstError <= tolerance, "the first block is off the golden render by " + juce::String(worstError));
+    }
+
+    //everything processBlock does besides following the knobs: morphing with
+    //different slopes, storing into the active snapshots, switching sources,
+    //loading state and the silence fast path, with varying block sizes
+    void runMorphAndSilence()
+    {
+        SimpleEQAudioProcessor processor;
+        processor.setChainSettings(getOtherSettings());
+        processor.storeSnapshot(1);
+        processor.setChainSettings(getBaseSettings());
+        processor.storeSnapshot(0);
+        prepare(processor);
+
+        juce::MemoryBlock state;
+        processor.getStateInformation(state);
+
+        //these filters ring for a few milliseconds, not forever
+        const auto tail = processor.getTailLengthSeconds();
+        expect(tail > 0.0 && tail < 1.0, "the tail is " + juce::String(tail) + " seconds");
+
+        auto* morph = processor.apvts.getParameter("Morph");
+        auto* morphEnabled = processor.apvts.getParameter("Morph Enabled");
+        processor.apvts.getParameter("Auto Gain")->setValueNotifyingHost(1.f);
+        morphEnabled->setValueNotifyingHost(1.f);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midiMessages;
+        juce::Random random(0xab);
+
+        constexpr int blockSizes[] = { 512, 64, 1, 300, 33 };
+        constexpr int numBlocksToRun = 400;
+        constexpr int silentFrom = 250;
+
+        RealtimeViolations violations;
+        auto peak = 0.f;
+        auto isFinite = true;
+        auto isSilentOnceDecayed = true;
+        int silentSamples = 0;
+
+        for (int block = 0; block < numBlocksToRun; ++block)
+        {
+            //the morph goes A to B and back twice
+            const auto phase = float(block % 100) / 50.f;
+            morph->setValueNotifyingHost(phase < 1.f ? phase : 2.f - phase);
+
+            //the message thread stores into the active snapshot mid morph,
+            //switches sources, and loads a state
+            if (block == 60)
+            {
+                auto settings = getBaseSettings();
+                settings.lowCutSlope = Slope_12;
+                settings.peakGainInDecibels = 12.f;
+                processor.setChainSettings(settings);
+                processor.storeSnapshot(0);
+            }
+
+            if (block == 120)
+                morphEnabled->setValueNotifyingHost(0.f);
+
+            if (block == 140)
+                morphEnabled->setValueNotifyingHost(1.f);
+
+            if (block == 180)
+                processor.setStateInformation(state.getData(), int(state.getSize()));
+
+            //low cut stages switched off mid morph come back, with nothing left to ring
+            if (block == 350)
+                processor.apvts.getParameter("LowCut Slope")->setValueNotifyingHost(1.f);
+
+            buffer.setSize(2, blockSizes[block % juce::numElementsInArray(blockSizes)], false, false, true);
+
+            if (block < silentFrom)
+                fillWithNoise(buffer, random, 0.25f);
+            else
+                buffer.clear();
+
+            beginRealtimeCheck();
+            processor.processBlock(buffer, midiMessages);
+            const auto blockViolations = endRealtimeCheck();
+
+            violations.allocations += blockViolations.allocations;
+            violations.deallocations += blockViolations.deallocations;
+            violations.locks += blockViolations.locks;
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    isFinite = isFinite && std::isfinite(buffer.getSample(channel, i));
+
+            peak = juce::jmax(peak, buffer.getMagnitude(0, buffer.getNumSamples()));
+
+            //the tail is 100 dB down, twice that is well past the fast path's threshold
+            const auto decayedAfter = int(2.0 * juce::jmin(1.0, processor.getTailLengthSeconds()) * sampleRate) + blockSize;
+
+            if (block >= silentFrom && silentSamples >= decayedAfter)
+                for (int channel = 0; channel < 2; ++channel)
+                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                        isSilentOnceDecayed = isSilentOnceDecayed && isSameValue(buffer.getSample(channel, i), 0.f);
+
+            if (block >= silentFrom)
+                silentSamples += buffer.getNumSamples();
+        }
+
+        expect(! violations.any(), "processBlock made " + describeRealtimeViolations(violations));
+        expect(isFinite, "processBlock produced a NaN or infinity");
+        expect(peak < 64.f, "processBlock blew up to " + juce::String(peak));
+        expect(isSilentOnceDecayed, "silent input into decayed filters didn't give exact silence");
+    }
+
+    //a low sine, where any jump of the filters stands out against the small
+    //steps between its samples: turning Morph Enabled on, storing into the
+    //active snapshot, and morphing across a change of slopes
+    void runTransitions()
+    {
+        SimpleEQAudioProcessor processor;
+        processor.setChainSettings(getBaseSettings());
+        processor.storeSnapshot(0);
+        processor.setChainSettings(getOtherSettings());
+        processor.storeSnapshot(1);
+        prepare(processor);
+
+        auto* morph = processor.apvts.getParameter("Morph");
+        auto* morphEnabled = processor.apvts.getParameter("Morph Enabled");
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midiMessages;
+
+        constexpr int numBlocksToRun = 100;
+        constexpr float frequency = 150.f, level = 0.5f;
+        const auto phaseStep = juce::MathConstants<float>::twoPi * frequency / float(sampleRate);
+
+        //the sine itself never moves by more than about this from one sample to the next
+        const auto largestStep = 2.f * level * phaseStep;
+
+        float previous[2] = {};
+        auto worstStep = 0.f;
+        int worstBlock = -1;
+        int sample = 0;
+
+        for (int block = 0; block < numBlocksToRun; ++block)
+        {
+            if (block == 20)
+                morphEnabled->setValueNotifyingHost(1.f);
+
+            if (block == 40)
+                processor.storeSnapshot(0);
+
+            if (block == 60)
+            {
+                processor.setChainSettings(getBaseSettings());
+                processor.storeSnapshot(0);
+            }
+
+            if (block == 80)
+                morph->setValueNotifyingHost(1.f);
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const auto value = level * std::sin(phaseStep * float(sample + i));
+                buffer.setSample(0, i, value);
+                buffer.setSample(1, i, value);
+            }
+
+            sample += blockSize;
+            processor.processBlock(buffer, midiMessages);
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const auto value = buffer.getSample(channel, i);
+
+                    //the first block is the filters starting from nothing
+                    if (block > 0 && std::abs(value - previous[channel]) > worstStep)
+                    {
+                        worstStep = std::abs(value - previous[channel]);
+                        worstBlock = block;
+                    }
+
+                    previous[channel] = value;
+                }
+            }
+        }
+
+        expect(worstStep <= largestStep, "block " + juce::String(worstBlock) + " jumps by "
+            + juce::String(worstStep) + ", the sine only moves by " + juce::String(largestStep));
+    }
+
+    //every parameter must come back from a saved state, not just the knobs
+    void runStateRoundTrip()
+    {
+        SimpleEQAudioProcessor saved;
+
+        for (auto* parameter : saved.getParameters())
+            parameter->setValueNotifyingHost(parameter->getDefaultValue() < 0.5f ? 0.73f : 0.21f);
+
+        juce::MemoryBlock state;
+        saved.getStateInformation(state);
+
+        SimpleEQAudioProcessor loaded;
+        loaded.setStateInformation(state.getData(), int(state.getSize()));
+
+        //compared as the plain values the processor reads, which are snapped to each
+        //parameter's interval, while the normalised value a host sets needn't be
+        for (int i = 0; i < saved.getParameters().size(); ++i)
+        {
+            auto& savedParameter = dynamic_cast<juce::RangedAudioParameter&>(*saved.getParameters()[i]);
+            auto& loadedParameter = dynamic_cast<juce::RangedAudioParameter&>(*loaded.getParameters()[i]);
+
+            const auto savedValue = savedParameter.convertFrom0to1(savedParameter.getValue());
+            const auto loadedValue = loadedParameter.convertFrom0to1(loadedParameter.getValue());
+
+            expect(isClose(loadedValue, savedValue),
+                savedParameter.getParameterID() + " was saved as " + juce::String(savedValue)
+                + " but loaded as " + juce::String(loadedValue));
+        }
+    }
+
+    //the case the tail was added for, a steep cut near the bottom of the range
+    //rings the longest, so its impulse response should die out within the
+    //reported tail, and not long before it
+    void runLowCutTail()
+    {
+        auto settings = getBaseSettings();
+        settings.lowCutFreq = 20.f;
+        settings.lowCutSlope = Slope_48;
+        settings.peakGainInDecibels = 0.f;
+        settings.highCutFreq = 20000.f;
+        settings.highCutSlope = Slope_12;
+
+        SimpleEQAudioProcessor processor;
+        processor.setChainSettings(settings);
+        prepare(processor);
+
+        const auto tail = processor.getTailLengthSeconds();
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midiMessages;
+
+        //long enough to see the impulse response well past any sensible tail
+        const auto numBlocksToRun = int(4.0 * sampleRate) / blockSize;
+
+        //the 20 Hz ringing starts about 40 dB below the impulse, so a loud one keeps
+        //it above the silence fast path's threshold until it's 100 dB down
+        constexpr float impulseLevel = 1000.f;
+
+        std::vector<float> response;
+        response.reserve(size_t(numBlocksToRun * blockSize));
+
+        for (int block = 0; block < numBlocksToRun; ++block)
+        {
+            buffer.clear();
+
+            if (block == 0)
+                for (int channel = 0; channel < 2; ++channel)
+                    buffer.setSample(channel, 0, impulseLevel);
+
+            processor.processBlock(buffer, midiMessages);
+
+            for (int i = 0; i < blockSize; ++i)
+                response.push_back(std::abs(buffer.getSample(0, i)));
+        }
+
+        //the ringing is what a host has to wait for, so the decay is measured from its
+        //peak, after the first millisecond where the impulse itself comes through
+        const auto directSamples = size_t(0.001 * sampleRate);
+        const auto ringPeak = *std::max_element(response.begin() + long(directSamples), response.end());
+        const auto threshold = ringPeak * juce::Decibels::decibelsToGain(-100.f, -200.f);
+
+        size_t lastAudible = 0;
+
+        for (size_t i = 0; i < response.size(); ++i)
+            if (response[i] > threshold)
+                lastAudible = i;
+
+        const auto measured = double(lastAudible + 1) / sampleRate;
+
+        logMessage("Reported tail " + juce::String(tail, 3) + " s, measured decay to -100 dB "
+            + juce::String(measured, 3) + " s");
+
+        expect(measured <= tail, "the response lasts " + juce::String(measured)
+            + " seconds, longer than the reported " + juce::String(tail));
+        expect(tail <= 1.5 * measured, "the reported tail of " + juce::String(tail)
+            + " seconds is far longer than the measured " + juce::String(measured));
+    }
+
+    //a session saved while morphing has to come back morphing between the same snapshots
+    void runMorphStateRoundTrip()
+    {
+        SimpleEQAudioProcessor saved;
+        saved.setChainSettings(getOtherSettings());
+        saved.storeSnapshot(1);
+        saved.setChainSettings(getBaseSettings());
+        saved.storeSnapshot(0);
+
+        //knobs away from both snapshots, they mustn't be what gets heard
+        auto knobs = getBaseSettings();
+        knobs.peakFreq = 4000.f;
+        knobs.peakGainInDecibels = -18.f;
+        saved.setChainSettings(knobs);
+
+        saved.apvts.getParameter("Morph Enabled")->setValueNotifyingHost(1.f);
+        saved.apvts.getParameter("Morph")->setValueNotifyingHost(0.3f);
+
+        juce::MemoryBlock state;
+        saved.getStateInformation(state);
+
+        SimpleEQAudioProcessor loaded;
+        loaded.setStateInformation(state.getData(), int(state.getSize()));
+
+        prepare(saved);
+        prepare(loaded);
+
+        juce::AudioBuffer<float> savedBuffer(2, blockSize), loadedBuffer(2, blockSize);
+        juce::MidiBuffer midiMessages;
+        juce::Random random(0x10ad);
+
+        auto worstError = 0.f;
+
+        for (int block = 0; block < 32; ++block)
+        {
+            fillWithNoise(savedBuffer, random, 0.25f);
+            loadedBuffer.makeCopyOf(savedBuffer, true);
+
+            saved.processBlock(savedBuffer, midiMessages);
+            loaded.processBlock(loadedBuffer, midiMessages);
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < blockSize; ++i)
+                    worstError = juce::jmax(worstError,
+                        std::abs(loadedBuffer.getSample(channel, i) - savedBuffer.getSample(channel, i)));
+        }
+
+        expect(worstError <= 1.0e-6f, "the reloaded processor is off the saved one by " + juce::String(worstError));
+    }
+
+    //sessions saved before the binary state hold the whole ValueTree, written as the
+    //original getStateInformation did
+    void runValueTreeStateLoad()
+    {
+        SimpleEQAudioProcessor saved;
+
+        for (auto* parameter : saved.getParameters())
+            parameter->setValueNotifyingHost(parameter->getDefaultValue() < 0.5f ? 0.73f : 0.21f);
+
+        juce::MemoryBlock state;
+        {
+            juce::MemoryOutputStream stream(state, true);
+            saved.apvts.copyState().writeToStream(stream);
+        }
+
+        SimpleEQAudioProcessor loaded;
+        loaded.setStateInformation(state.getData(), int(state.getSize()));
+
+        for (int i = 0; i < saved.getParameters().size(); ++i)
+        {
+            auto& savedParameter = dynamic_cast<juce::RangedAudioParameter&>(*saved.getParameters()[i]);
+            auto& loadedParameter = dynamic_cast<juce::RangedAudioParameter&>(*loaded.getParameters()[i]);
+
+            const auto savedValue = savedParameter.convertFrom0to1(savedParameter.getValue());
+            const auto loadedValue = loadedParameter.convertFrom0to1(loadedParameter.getValue());
+
+            expect(isClose(loadedValue, savedValue),
+                savedParameter.getParameterID() + " was saved as " + juce::String(savedValue)
+                + " in a ValueTree state but loaded as " + juce::String(loadedValue));
+        }
+    }
+
+    //states saved before every parameter was stored hold ChainSettings and Auto Gain
+    void runVersion2StateLoad()
+    {
+        const auto settings = getOtherSettings();
+
+        juce::MemoryBlock state;
+        {
+            juce::MemoryOutputStream stream(state, false);
+            stream.writeInt(0x53514553);
+            stream.writeInt(2);
+            stream.writeInt(5 * int(sizeof(float)) + 3 * int(sizeof(int)));
+            stream.writeFloat(settings.peakFreq);
+            stream.writeFloat(settings.peakGainInDecibels);
+            stream.writeFloat(settings.peakQuality);
+            stream.writeFloat(settings.lowCutFreq);
+            stream.writeFloat(settings.highCutFreq);
+            stream.writeInt(settings.lowCutSlope);
+            stream.writeInt(settings.highCutSlope);
+            stream.writeInt(1);
+        }
+
+        SimpleEQAudioProcessor processor;
+        processor.setStateInformation(state.getData(), int(state.getSize()));
+
+        const auto loaded = getChainSettings(processor.apvts);
+        expect(isClose(loaded.peakFreq, settings.peakFreq)
+            && isClose(loaded.peakGainInDecibels, settings.peakGainInDecibels)
+            && isClose(loaded.peakQuality, settings.peakQuality)
+            && isClose(loaded.lowCutFreq, settings.lowCutFreq)
+            && isClose(loaded.highCutFreq, settings.highCutFreq)
+            && loaded.lowCutSlope == settings.lowCutSlope
+            && loaded.highCutSlope == settings.highCutSlope,
+            "the settings in a version 2 state weren't loaded");
+        expect(processor.apvts.getParameter("Auto Gain")->getValue() > 0.5f,
+            "Auto Gain in a version 2 state wasn't loaded");
+    }
+};
+
+static ProcessorTests processorTests;
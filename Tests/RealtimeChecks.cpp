@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+    Detects heap allocations and blocking locks on the calling thread,
+    so tests can prove a piece of code is safe to run on the audio thread.
+
+  ==============================================================================
+*/
+
+#include "RealtimeChecks.h"
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #include <cerrno>
+#endif
+
+//plain thread locals, reaching them never allocates
+static thread_local bool isChecking = false;
+static thread_local int numAllocations = 0;
+static thread_local int numDeallocations = 0;
+static thread_local int numLocks = 0;
+
+static void noteAllocation()
+{
+    if (isChecking)
+        ++numAllocations;
+}
+
+static void noteDeallocation(void* pointer)
+{
+    if (isChecking && pointer != nullptr)
+        ++numDeallocations;
+}
+
+void beginRealtimeCheck()
+{
+    numAllocations = numDeallocations = numLocks = 0;
+    isChecking = true;
+}
+
+RealtimeViolations endRealtimeCheck()
+{
+    isChecking = false;
+
+    RealtimeViolations violations;
+    violations.allocations = numAllocations;
+    violations.deallocations = numDeallocations;
+    violations.locks = numLocks;
+    return violations;
+}
+
+juce::String describeRealtimeViolations(const RealtimeViolations& violations)
+{
+    return juce::String(violations.allocations) + " allocations, "
+        + juce::String(violations.deallocations) + " frees, "
+        + juce::String(violations.locks) + " locks";
+}
+
+//==============================================================================
+#if JUCE_LINUX
+
+//glibc's own entry points, which the hooks below forward to.
+//Hooking malloc itself also catches juce::HeapBlock and C libraries,
+//and operator new, which calls malloc
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* pointer);
+
+    void* malloc(size_t size) noexcept
+    {
+        noteAllocation();
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        noteAllocation();
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        noteAllocation();
+        return __libc_realloc(pointer, size);
+    }
+
+    void* memalign(size_t alignment, size_t size) noexcept
+    {
+        noteAllocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        noteAllocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+    {
+        if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        noteAllocation();
+        *result = __libc_memalign(alignment, size);
+        return *result != nullptr ? 0 : ENOMEM;
+    }
+
+    void free(void* pointer) noexcept
+    {
+        noteDeallocation(pointer);
+        __libc_free(pointer);
+    }
+
+    //std::mutex, juce::CriticalSection and juce::WaitableEvent all end up here.
+    //try locks never block, so they are left alone
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        using LockFunction = int (*)(pthread_mutex_t*);
+
+        //looked up without a function static, whose guard could lock
+        static std::atomic<LockFunction> realLock{ nullptr };
+
+        if (isChecking)
+            ++numLocks;
+
+        auto lock = realLock.load(std::memory_order_relaxed);
+        if (lock == nullptr)
+        {
+            lock = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+            realLock.store(lock, std::memory_order_relaxed);
+        }
+
+        return lock(mutex);
+    }
+}
+
+bool canDetectLocks()
+{
+    return true;
+}
+
+#else
+
+//elsewhere only operator new can be replaced portably
+void* operator new(std::size_t size)
+{
+    noteAllocation();
+
+    if (auto* pointer = std::malloc(size > 0 ? size : 1))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    noteAllocation();
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& nothrow) noexcept
+{
+    return operator new(size, nothrow);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    noteDeallocation(pointer);
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+bool canDetectLocks()
+{
+    return false;
+}
+
+#endif
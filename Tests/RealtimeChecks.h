@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+
+    Detects heap allocations and blocking locks on the calling thread,
+    so tests can prove a piece of code is safe to run on the audio thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//what a thread did while it was being checked
+struct RealtimeViolations
+{
+    int allocations{ 0 };
+    int deallocations{ 0 };
+    int locks{ 0 };
+
+    bool any() const { return allocations > 0 || deallocations > 0 || locks > 0; }
+};
+
+//counts heap allocations, frees and blocking mutex locks made by
+//the calling thread from beginRealtimeCheck until endRealtimeCheck
+//other threads are never counted
+void beginRealtimeCheck();
+RealtimeViolations endRealtimeCheck();
+
+//mutex locks are only seen where the pthread functions can be interposed,
+//allocations through operator new are seen everywhere
+bool canDetectLocks();
+
+juce::String describeRealtimeViolations(const RealtimeViolations& violations);
@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    The filter chain as it was before processBlock moved to the raw
+    kernels: juce::dsp::IIR::Filter cascades designed by juce itself.
+    Its output is the golden render the processor is compared against.
+
+  ==============================================================================
+*/
+
+#include "ReferenceChain.h"
+
+using CoefficientsPtr = juce::dsp::IIR::Coefficients<float>::Ptr;
+using CutCoefficientsArray = juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>>;
+
+static CoefficientsPtr makeReferencePeak(const ChainSettings& chainSettings, double sampleRate)
+{
+    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate,
+        chainSettings.peakFreq, chainSettings.peakQuality,
+        juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+}
+
+static CutCoefficientsArray makeReferenceLowCut(const ChainSettings& chainSettings, double sampleRate)
+{
+    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq,
+        sampleRate, 2 * (chainSettings.lowCutSlope + 1));
+}
+
+static CutCoefficientsArray makeReferenceHighCut(const ChainSettings& chainSettings, double sampleRate)
+{
+    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq,
+        sampleRate, 2 * (chainSettings.highCutSlope + 1));
+}
+
+//stages past the slope are bypassed and keep their old coefficients and state
+template <int Index, typename CutFilterType>
+static void updateCutStage(CutFilterType& cutChain, const CutCoefficientsArray& coefficients, Slope slope)
+{
+    const auto isUsed = Index <= slope;
+
+    if (isUsed)
+        *cutChain.template get<Index>().coefficients = *coefficients[Index];
+
+    cutChain.template setBypassed<Index>(! isUsed);
+}
+
+template <typename CutFilterType>
+static void updateCutFilter(CutFilterType& cutChain, const CutCoefficientsArray& coefficients, Slope slope)
+{
+    updateCutStage<0>(cutChain, coefficients, slope);
+    updateCutStage<1>(cutChain, coefficients, slope);
+    updateCutStage<2>(cutChain, coefficients, slope);
+    updateCutStage<3>(cutChain, coefficients, slope);
+}
+
+void ReferenceChain::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(maximumBlockSize);
+    spec.numChannels = 1;
+
+    leftChain.prepare(spec);
+    rightChain.prepare(spec);
+}
+
+void ReferenceChain::update(const ChainSettings& chainSettings)
+{
+    auto peak = makeReferencePeak(chainSettings, sampleRate);
+    *leftChain.get<Peak>().coefficients = *peak;
+    *rightChain.get<Peak>().coefficients = *peak;
+
+    auto lowCut = makeReferenceLowCut(chainSettings, sampleRate);
+    updateCutFilter(leftChain.get<LowCut>(), lowCut, chainSettings.lowCutSlope);
+    updateCutFilter(rightChain.get<LowCut>(), lowCut, chainSettings.lowCutSlope);
+
+    auto highCut = makeReferenceHighCut(chainSettings, sampleRate);
+    updateCutFilter(leftChain.get<HighCut>(), highCut, chainSettings.highCutSlope);
+    updateCutFilter(rightChain.get<HighCut>(), highCut, chainSettings.highCutSlope);
+}
+
+void ReferenceChain::process(juce::AudioBuffer<float>& buffer)
+{
+    juce::dsp::AudioBlock<float> block(buffer);
+    auto leftBlock = block.getSingleChannelBlock(0);
+    auto rightBlock = block.getSingleChannelBlock(1);
+
+    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
+    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+
+    leftChain.process(leftContext);
+    rightChain.process(rightContext);
+}
+
+float ReferenceChain::getLoudnessCompensation(const ChainSettings& chainSettings, double sampleRate)
+{
+    constexpr int numPoints = 64;
+
+    auto peak = makeReferencePeak(chainSettings, sampleRate);
+    auto lowCut = makeReferenceLowCut(chainSettings, sampleRate);
+    auto highCut = makeReferenceHighCut(chainSettings, sampleRate);
+
+    double power = 0.0;
+
+    for (int i = 0; i < numPoints; ++i)
+    {
+        auto freq = juce::mapToLog10(double(i) / double(numPoints - 1), 20.0, 20000.0);
+        freq = juce::jmin(freq, 0.49 * sampleRate);
+
+        auto magnitude = peak->getMagnitudeForFrequency(freq, sampleRate);
+
+        for (int s = 0; s <= chainSettings.lowCutSlope; ++s)
+            magnitude *= lowCut[s]->getMagnitudeForFrequency(freq, sampleRate);
+
+        for (int s = 0; s <= chainSettings.highCutSlope; ++s)
+            magnitude *= highCut[s]->getMagnitudeForFrequency(freq, sampleRate);
+
+        power += magnitude * magnitude;
+    }
+
+    power /= numPoints;
+
+    const auto compensation = 1.0 / std::sqrt(juce::jmax(power, 1.0e-12));
+    return static_cast<float>(juce::jlimit(juce::Decibels::decibelsToGain(-24.0),
+        juce::Decibels::decibelsToGain(24.0), compensation));
+}
@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    The filter chain as it was before processBlock moved to the raw
+    kernels: juce::dsp::IIR::Filter cascades designed by juce itself.
+    Its output is the golden render the processor is compared against.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+
+class ReferenceChain
+{
+public:
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    //redesigns every filter, like the original updateFilters did on every block
+    void update(const ChainSettings& chainSettings);
+
+    //left and right, in place
+    void process(juce::AudioBuffer<float>& buffer);
+
+    //auto gain the processor should arrive at for these settings, from juce's
+    //own magnitude response on the same 64 point log grid, 20 Hz to 20 kHz
+    static float getLoudnessCompensation(const ChainSettings& chainSettings, double sampleRate);
+
+private:
+    using Filter = juce::dsp::IIR::Filter<float>;
+    using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
+    using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
+
+    enum ChainPositions
+    {
+        LowCut,
+        Peak,
+        HighCut
+    };
+
+    MonoChain leftChain, rightChain;
+    double sampleRate{ 44100.0 };
+};
@@ -0,0 +1,25 @@
+/*
+  ==============================================================================
+
+    Runs every SimpleEQ unit test, and fails if any of them does.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+int main()
+{
+    //parameters and the value tree expect a message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory("SimpleEQ");
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult(i)->failures;
+
+    return failures > 0 ? 1 : 0;
+}